@@ -0,0 +1,168 @@
+#ifndef ANGULAR_SORT_HPP_
+#define ANGULAR_SORT_HPP_
+
+#include "linalg.hpp"
+#include "filtered_predicates.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace zonotope {
+
+/**
+ * @brief Sorts the event points of handle_event_points by angle in `[0, pi)`
+ *
+ * The event 2*i stands for the point (x[i], y[i]), and the event 2*i+1
+ * for (-x[i], -y[i]). Every event must lie in the upper half-plane,
+ * i.e. on the positive x-axis or strictly above the x-axis.
+ *
+ * The events on the x-axis all have angle 0 and come first. The
+ * others are sorted by the key `-x/y`, which increases with the angle
+ * and does not depend on the sign of the event. The keys are computed
+ * in double, so that sorting takes no exact multiplications. Since
+ * each key has a relative error of at most a few ulps, two events can
+ * only be out of order if they are in a run of consecutive keys that
+ * are within that error of each other, and those runs are sorted again
+ * with the exact comparison. Events with the same angle are ordered by
+ * index, and starts_angle tells which events start a new angle.
+ *
+ * An instance keeps its key buffer, so it should be reused from call
+ * to call.
+ */
+template <typename Number_t>
+class Angular_sort {
+public:
+
+  void operator() ( const std::vector<Number_t>& x,
+                    const std::vector<Number_t>& y,
+                    std::vector<int>& events )
+  {
+    // the events on the x-axis first, in the order they are given
+    keyed_.clear();
+    int num_axis_events = 0;
+    bool finite = true;
+    for ( const int event : events ) {
+      const int i = event >> 1;
+      if ( y[i] == 0 ) {
+        events[num_axis_events++] = event;
+      } else {
+        const double key = -_to_double(x[i]) / _to_double(y[i]);
+        finite = finite && std::isfinite(key);
+        keyed_.push_back( std::make_pair(key, event) );
+      }
+    }
+
+    const auto first = keyed_.begin();
+    const auto last = keyed_.end();
+    const Exact_compare exact { x, y };
+
+    const int num_events = events.size();
+    starts_angle_.assign( num_events, 0 );
+    if ( num_axis_events > 0 ) {
+      starts_angle_[0] = 1;
+    }
+    char* keyed_starts_angle = starts_angle_.data() + num_axis_events;
+
+    if ( ! finite ) {
+      // the numbers are out of the range of double
+      std::sort( first, last, exact );
+      mark_angles( first, last, exact, keyed_starts_angle );
+    } else {
+      std::sort( first, last );
+
+      // sort the runs of nearly equal keys exactly
+      auto run_begin = first;
+      while ( run_begin != last ) {
+        auto run_end = run_begin + 1;
+        while ( run_end != last && nearly_equal( (run_end-1)->first, run_end->first ) ) {
+          ++run_end;
+        }
+        if ( run_end - run_begin > 1 ) {
+          std::sort( run_begin, run_end, exact );
+          mark_angles( run_begin, run_end, exact, keyed_starts_angle + (run_begin - first) );
+        } else {
+          keyed_starts_angle[run_begin - first] = 1;
+        }
+        run_begin = run_end;
+      }
+    }
+
+    for ( const auto& keyed_event : keyed_ ) {
+      events[num_axis_events++] = keyed_event.second;
+    }
+  }
+
+  /**
+   * @brief true iff the event at the given position of the last sorted
+   *        events has a larger angle than the one before it.
+   */
+  bool starts_angle( const int position ) const {
+    return starts_angle_[position];
+  }
+
+private:
+
+  /**
+   * @brief true iff the computed keys a <= b may belong to events in
+   *        the opposite order.
+   *
+   * Each input of the division is rounded or truncated once, and the
+   * division rounds once more, so the relative error of a key is below
+   * 3*DBL_EPSILON.
+   */
+  static bool nearly_equal( const double a, const double b ) {
+    return ( b - a ) <= 8 * DBL_EPSILON * std::max( std::fabs(a), std::fabs(b) ) + DBL_MIN;
+  }
+
+  /**
+   * @brief The exact order by angle, and then by index
+   */
+  struct Exact_compare {
+    const std::vector<Number_t>& x;
+    const std::vector<Number_t>& y;
+
+    bool operator() ( const std::pair<double, int>& a,
+                      const std::pair<double, int>& b ) const {
+      const int ia = a.second >> 1;
+      const int ib = b.second >> 1;
+      // with the signs sa, sb of the events, a comes first iff
+      //   sa*x[ia] * sb*y[ib] > sb*x[ib] * sa*y[ia]
+      const int sign = sign_of_mul_sub(x[ia], y[ib], x[ib], y[ia]);
+      if ( sign == 0 ) {
+        return a.second < b.second;
+      }
+      const bool same_sign = ( ( a.second ^ b.second ) & 1 ) == 0;
+      return same_sign ? ( sign > 0 ) : ( sign < 0 );
+    }
+  };
+
+  /**
+   * @brief Mark the exactly sorted events in [begin, end) that start a
+   *        new angle.
+   */
+  template <typename Iterator_t>
+  static void mark_angles( const Iterator_t begin,
+                           const Iterator_t end,
+                           const Exact_compare& exact,
+                           char* starts_angle ) {
+    if ( begin == end ) {
+      return;
+    }
+    starts_angle[0] = 1;
+    for ( Iterator_t it = begin + 1; it != end; ++it ) {
+      const int ia = (it-1)->second >> 1;
+      const int ib = it->second >> 1;
+      starts_angle[it - begin] = ( sign_of_mul_sub(exact.x[ia], exact.y[ib], exact.x[ib], exact.y[ia]) != 0 );
+    }
+  }
+
+  std::vector<std::pair<double, int> > keyed_;
+  std::vector<char> starts_angle_;
+};
+
+} // namespace zonotope
+
+#endif // ANGULAR_SORT_HPP_
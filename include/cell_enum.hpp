@@ -9,8 +9,11 @@
  */
 
 #include "reverse_search.hpp"
+#include "parallel_reverse_search.hpp"
 #include "linalg.hpp"
 
+#include <cassert>
+#include <cstdint>
 #include <vector>
 
 #include <CGAL/basic.h>
@@ -60,7 +63,7 @@ struct Arrangement_adjacency_oracle {
         for ( int j = 0; j < d; ++j ) {
           lp.set_a(j, i, c[i]*A[i][j]);
         }
-        lp.set_b(k, c[i]*b[i]);
+        lp.set_b(i, c[i]*b[i]);
       }
     }
 
@@ -81,11 +84,141 @@ struct Arrangement_adjacency_oracle {
   }
 };
 
-template <typename Number_t> 
+/**
+ * @brief Same queries as Arrangement_adjacency_oracle, but reuses one
+ *        linear program, and remembers the recent answers.
+ *
+ * The program holds the rows A[i]*x >= b[i] for the whole
+ * arrangement. For a query on the cell c, only the relations of the
+ * rows where c differs from the previous query are flipped (c[i] = -1
+ * turns row i into A[i]*x <= b[i]), and row k is zeroed out while the
+ * program is solved. Reverse search asks for the same (cell, k) pairs
+ * repeatedly: the local search of every candidate child, and again
+ * when it restores neighbor_counter on backtracking. The answers are
+ * therefore kept in a direct-mapped cache of `cache_size` entries,
+ * which must be a positive power of two.
+ *
+ * CGAL's solver cannot be started from a given basis, so every query
+ * still solves its program from scratch.
+ *
+ * The program and the cache are modified by the queries, so an
+ * instance must not be shared between threads.
+ */
+template <typename Number_t>
+struct Cached_arrangement_adjacency_oracle {
+  const int n;
+  const int d;
+
+  typedef CGAL::Quadratic_program<Number_t> Program;
+  typedef CGAL::Quadratic_program_solution<Number_t> Solution;
+
+  const std::vector<std::vector<Number_t> >& A;
+  const std::vector<Number_t>& b;
+
+  Cached_arrangement_adjacency_oracle( const std::vector<std::vector<Number_t> >& A,
+                                       const std::vector<Number_t>& b,
+                                       const int cache_size = 1024 ) :
+    n(A.size()),
+    d(A[0].size()),
+    A(A),
+    b(b),
+    lp(CGAL::LARGER, false, 0, false, 0),
+    lp_signs(n, +1),
+    cache(cache_size),
+    cache_mask(cache_size - 1)
+  {
+    assert( cache_size > 0 && ( cache_size & ( cache_size - 1 ) ) == 0 );
+    for ( int i = 0; i < n; ++i ) {
+      for ( int j = 0; j < d; ++j ) {
+        lp.set_a(j, i, A[i][j]);
+      }
+      lp.set_b(i, b[i]);
+    }
+  }
+
+  Cell_t operator() (const Cell_t& c, const int neighbor_counter) const {
+    const int k = neighbor_counter - 1;
+
+    Cache_entry& entry = cache[cache_slot(c, k)];
+    if ( entry.k != k || entry.cell != c ) {
+      entry.cell = c;
+      entry.k = k;
+      entry.is_adjacent = solve(c, k);
+    }
+
+    if ( ! entry.is_adjacent ) {
+      return NONE_CELL;
+    }
+    Cell_t c_result = c;
+    c_result[k] *= -1;
+    return c_result;
+  }
+
+private:
+
+  struct Cache_entry {
+    Cell_t cell;
+    int k;
+    bool is_adjacent;
+
+    Cache_entry() : k(-1), is_adjacent(false) {}
+  };
+
+  long cache_slot(const Cell_t& c, const int k) const {
+    std::uint64_t h = 0xcbf29ce484222325ULL ^ std::uint64_t(k);
+    for ( int i = 0; i < n; ++i ) {
+      h = ( h ^ std::uint64_t(c[i] > 0) ) * 0x100000001b3ULL;
+    }
+    return ( h ^ (h >> 32) ) & cache_mask;
+  }
+
+  /**
+   * @brief Does the cell c have a neighbor across the hyperplane k?
+   */
+  bool solve(const Cell_t& c, const int k) const {
+    // flip the rows whose sign changed since the previous query
+    for ( int i = 0; i < n; ++i ) {
+      if ( c[i] != lp_signs[i] ) {
+        lp.set_r(i, ( c[i] > 0 ) ? CGAL::LARGER : CGAL::SMALLER);
+        lp_signs[i] = c[i];
+      }
+    }
+
+    // the objective is c[k]*(A[k]*x - b[k]), and row k is dropped
+    for ( int j = 0; j < d; ++j ) {
+      lp.set_c(j, c[k]*A[k][j]);
+      lp.set_a(j, k, 0);
+    }
+    lp.set_c0(-c[k]*b[k]);
+    lp.set_b(k, 0);
+
+    Solution lp_solution = CGAL::solve_linear_program(lp, Number_t());
+
+    for ( int j = 0; j < d; ++j ) {
+      lp.set_a(j, k, A[k][j]);
+    }
+    lp.set_b(k, b[k]);
+
+    if ( lp_solution.is_infeasible() ) {
+      return false;
+    }
+    // adjacent iff there is a feasible solution with a strictly
+    // negative objective value
+    return lp_solution.is_unbounded() || ( lp_solution.objective_value() < 0 );
+  }
+
+  mutable Program lp;
+  mutable Cell_t lp_signs;
+  mutable std::vector<Cache_entry> cache;
+  const long cache_mask;
+};
+
+template <typename Number_t,
+          typename Adjacency_oracle_t = Arrangement_adjacency_oracle<Number_t> >
 struct Arrangement_finite_local_search {
-  const Arrangement_adjacency_oracle<Number_t> Adj;
+  const Adjacency_oracle_t& Adj;
 
-  Arrangement_finite_local_search( const Arrangement_adjacency_oracle<Number_t>& Adj ) :
+  Arrangement_finite_local_search( const Adjacency_oracle_t& Adj ) :
     Adj(Adj) {}
 
   Cell_t operator() (const Cell_t& c) const {
@@ -124,27 +257,29 @@ struct Translated_output_functor {
   }
 };
 
-template <typename Number_t, typename Output_functor>
-void enumerate_cells_reverse_search (
+/**
+ * @brief Re-orient the hyperplanes so that the root cell, which
+ *        contains root_interior_point, has the sign vector (+1, ..., +1)
+ *
+ * translation_sign_vector[i] is -1 iff hyperplane i was flipped.
+ */
+template <typename Number_t>
+void orient_arrangement_to_root (
     const std::vector<std::vector<Number_t> >& A,
     const std::vector<Number_t>& b,
-    Output_functor& output) 
+    const std::vector<Number_t>& root_interior_point,
+    std::vector<std::vector<Number_t> >& A_translated,
+    std::vector<Number_t>& b_translated,
+    Cell_t& translation_sign_vector)
 {
   const int n = A.size();
   const int d = A[0].size();
 
-  // TODO: a better way to select the root interior point
-  std::vector<Number_t> root_interior_point (d, 1); 
-  Cell_t root_sign_vector (n, +1); 
-  
-  // re-orient the hyperplanes to fit root_sign_vector with respect to
-  // root_interior_point
-  std::vector<std::vector<Number_t> > A_translated = A;
-  std::vector<Number_t> b_translated = b;
-
-  Cell_t translation_sign_vector (n, 1);
+  A_translated = A;
+  b_translated = b;
+  translation_sign_vector.assign(n, 1);
   for ( int i = 0; i < n; ++i ) {
-    if ( dot<Number_t> (root_interior_point, A[i]) <= b[i] ) {
+    if ( zonotope::dot<Number_t> (root_interior_point, A[i]) <= b[i] ) {
       translation_sign_vector[i] = -1;
       b_translated[i] *= -1;
       for ( int j = 0; j < d; ++j ) {
@@ -152,20 +287,133 @@ void enumerate_cells_reverse_search (
       }
     }
   }
+}
+
+/**
+ * @brief enumerate_cells_reverse_search, with reverse_search_with_stack
+ *        if with_stack is true
+ */
+template <typename Number_t, typename Output_functor>
+void _enumerate_cells_reverse_search (
+    const std::vector<std::vector<Number_t> >& A,
+    const std::vector<Number_t>& b,
+    Output_functor& output,
+    const bool with_stack)
+{
+  const int n = A.size();
+  const int d = A[0].size();
+
+  // TODO: a better way to select the root interior point
+  std::vector<Number_t> root_interior_point (d, 1); 
+  Cell_t root_sign_vector (n, +1); 
+  
+  // re-orient the hyperplanes to fit root_sign_vector with respect to
+  // root_interior_point
+  std::vector<std::vector<Number_t> > A_translated;
+  std::vector<Number_t> b_translated;
+  Cell_t translation_sign_vector;
+  orient_arrangement_to_root<Number_t>( A, b, root_interior_point,
+                                        A_translated, b_translated,
+                                        translation_sign_vector );
 
   // init functors
-  Arrangement_adjacency_oracle<Number_t> Adj (A_translated, b_translated);
-  Arrangement_finite_local_search<Number_t> f (Adj);
+  typedef Cached_arrangement_adjacency_oracle<Number_t> Adjacency_oracle_t;
+  typedef Arrangement_finite_local_search<Number_t, Adjacency_oracle_t> Local_search_t;
+  Adjacency_oracle_t Adj (A_translated, b_translated);
+  Local_search_t f (Adj);
   Translated_output_functor<Output_functor>
     translated_output (output, translation_sign_vector);
 
   // perform the reverse search
-  reverse_search<
+  if ( with_stack ) {
+    // every step of f flips a sign from -1 to +1, so the stack of
+    // ancestors holds at most n cells
+    reverse_search_with_stack<
+      Adjacency_oracle_t,
+      Local_search_t,
+      Cell_t,
+      Translated_output_functor<Output_functor> >
+        ( Adj, Adj.n, root_sign_vector, NONE_CELL, f, translated_output );
+  } else {
+    reverse_search<
+      Adjacency_oracle_t,
+      Local_search_t,
+      Cell_t,
+      Translated_output_functor<Output_functor> >
+        ( Adj, Adj.n, root_sign_vector, NONE_CELL, f, translated_output );
+  }
+}
+
+template <typename Number_t, typename Output_functor>
+void enumerate_cells_reverse_search (
+    const std::vector<std::vector<Number_t> >& A,
+    const std::vector<Number_t>& b,
+    Output_functor& output) 
+{
+  _enumerate_cells_reverse_search(A, b, output, false);
+}
+
+/**
+ * @brief Same as enumerate_cells_reverse_search, but with
+ *        reverse_search_with_stack, which keeps the cells on the path
+ *        to the root (at most n) instead of recomputing them on
+ *        backtracking
+ */
+template <typename Number_t, typename Output_functor>
+void enumerate_cells_reverse_search_with_stack (
+    const std::vector<std::vector<Number_t> >& A,
+    const std::vector<Number_t>& b,
+    Output_functor& output)
+{
+  _enumerate_cells_reverse_search(A, b, output, true);
+}
+
+/**
+ * @brief Same as enumerate_cells_reverse_search, but distributes the
+ *        search over outputs.size() threads with
+ *        parallel_reverse_search.
+ *
+ * Each thread passes its cells to its own output functor,
+ * outputs[thread_index], so outputs must not be empty. The threads
+ * share an Arrangement_adjacency_oracle, which builds an independent
+ * linear program for every query (the cached oracle of the sequential
+ * version is not thread-safe).
+ */
+template <typename Number_t, typename Output_functor>
+void enumerate_cells_reverse_search_parallel (
+    const std::vector<std::vector<Number_t> >& A,
+    const std::vector<Number_t>& b,
+    std::vector<Output_functor>& outputs,
+    const long budget = 1000)
+{
+  typedef Translated_output_functor<Output_functor> Translated_output_t;
+
+  const int n = A.size();
+  const int d = A[0].size();
+
+  std::vector<Number_t> root_interior_point (d, 1);
+  Cell_t root_sign_vector (n, +1);
+
+  std::vector<std::vector<Number_t> > A_translated;
+  std::vector<Number_t> b_translated;
+  Cell_t translation_sign_vector;
+  orient_arrangement_to_root<Number_t>( A, b, root_interior_point,
+                                        A_translated, b_translated,
+                                        translation_sign_vector );
+
+  Arrangement_adjacency_oracle<Number_t> Adj (A_translated, b_translated);
+  Arrangement_finite_local_search<Number_t> f (Adj);
+  std::vector<Translated_output_t> translated_outputs;
+  for ( Output_functor& output : outputs ) {
+    translated_outputs.push_back( Translated_output_t(output, translation_sign_vector) );
+  }
+
+  parallel_reverse_search<
     Arrangement_adjacency_oracle<Number_t>,
     Arrangement_finite_local_search<Number_t>,
-    Cell_t, 
-    Translated_output_functor<Output_functor> > 
-      ( Adj, Adj.n, root_sign_vector, NONE_CELL, f, translated_output );
+    Cell_t,
+    Translated_output_t >
+      ( Adj, Adj.n, root_sign_vector, NONE_CELL, f, translated_outputs, budget );
 }
 
 #endif // CELL_ENUM_HPP_
@@ -0,0 +1,652 @@
+#ifndef CHECKED_INTEGER_HPP_
+#define CHECKED_INTEGER_HPP_
+
+#include "linalg.hpp"
+#include "standardize_vector.hpp"
+#include "type_casting_functor.hpp"
+#include "preprocess_generators.hpp"
+#include "generator_projection.hpp"
+#include "filtered_predicates.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include <iostream>
+#include <gmpxx.h>
+
+namespace zonotope {
+
+/**
+ * @brief An arbitrary precision integer with a fixed-width fast path.
+ *
+ * The value is stored in an int64_t for as long as it fits, and every
+ * operation on two such values is checked for overflow. Only when an
+ * operation overflows is the result stored in an mpz_class, and as
+ * soon as an mpz_class result fits in an int64_t again, it is moved
+ * back into the fixed-width representation. This way, the fraction
+ * free updates in linalg.hpp only pay for GMP in the parts of the
+ * traversal where the intermediates actually grow large.
+ *
+ * It is intended to be used as the Internal_number_t of
+ * zonotope_volume and zonotope_halfspaces.
+ *
+ * __Invariant:__ big_ is non-null iff the value does not fit in an
+ * int64_t.
+ */
+class Checked_integer {
+public:
+
+  Checked_integer() : small_(0), big_(nullptr) {}
+  Checked_integer(int x) : small_(x), big_(nullptr) {}
+  Checked_integer(long x) : small_(x), big_(nullptr) {}
+  Checked_integer(long long x) : small_(x), big_(nullptr) {}
+
+  Checked_integer(const mpz_class& x) : small_(0), big_(nullptr) {
+    set_mpz(x);
+  }
+
+  Checked_integer(const Checked_integer& other)
+    : small_(other.small_)
+    , big_( other.big_ ? new mpz_class(*other.big_) : nullptr )
+    { }
+
+  Checked_integer(Checked_integer&& other)
+    : small_(other.small_)
+    , big_(other.big_)
+  {
+    other.big_ = nullptr;
+  }
+
+  ~Checked_integer() {
+    delete big_;
+  }
+
+  Checked_integer& operator= (const Checked_integer& other) {
+    if ( other.is_small() ) {
+      set_small(other.small_);
+    } else if ( is_small() ) {
+      big_ = new mpz_class(*other.big_);
+    } else {
+      *big_ = *other.big_;
+    }
+    return *this;
+  }
+
+  Checked_integer& operator= (Checked_integer&& other) {
+    std::swap(small_, other.small_);
+    std::swap(big_, other.big_);
+    return *this;
+  }
+
+  Checked_integer& operator= (long x) {
+    set_small(x);
+    return *this;
+  }
+
+  Checked_integer& operator= (const mpz_class& x) {
+    set_mpz(x);
+    return *this;
+  }
+
+  /**
+   * @brief true iff the value is stored in the fixed-width representation
+   */
+  bool is_small() const {
+    return ( big_ == nullptr );
+  }
+
+  /**
+   * @brief The value, provided that is_small()
+   */
+  int64_t small_value() const {
+    return small_;
+  }
+
+  /**
+   * @brief The value, provided that ! is_small()
+   */
+  const mpz_class& big_value() const {
+    return *big_;
+  }
+
+  mpz_class get_mpz() const {
+    if ( is_small() ) {
+      return mpz_class( long(small_) );
+    }
+    return *big_;
+  }
+
+  double get_d() const {
+    if ( is_small() ) {
+      return double(small_);
+    }
+    return big_->get_d();
+  }
+
+  bool fits_slong_p() const {
+    return is_small();
+  }
+
+  int sgn() const {
+    if ( is_small() ) {
+      return ( small_ > 0 ) - ( small_ < 0 );
+    }
+    return ::sgn(*big_);
+  }
+
+  Checked_integer& operator+= (const Checked_integer& other) {
+    int64_t result;
+    if ( is_small() && other.is_small() ) {
+      if ( ! __builtin_add_overflow(small_, other.small_, &result) ) {
+        small_ = result;
+        return *this;
+      }
+    }
+    promote();
+    if ( other.is_small() ) {
+      *big_ += long(other.small_);
+    } else {
+      *big_ += *other.big_;
+    }
+    normalize();
+    return *this;
+  }
+
+  Checked_integer& operator-= (const Checked_integer& other) {
+    int64_t result;
+    if ( is_small() && other.is_small() ) {
+      if ( ! __builtin_sub_overflow(small_, other.small_, &result) ) {
+        small_ = result;
+        return *this;
+      }
+    }
+    promote();
+    if ( other.is_small() ) {
+      *big_ -= long(other.small_);
+    } else {
+      *big_ -= *other.big_;
+    }
+    normalize();
+    return *this;
+  }
+
+  Checked_integer& operator*= (const Checked_integer& other) {
+    int64_t result;
+    if ( is_small() && other.is_small() ) {
+      if ( ! __builtin_mul_overflow(small_, other.small_, &result) ) {
+        small_ = result;
+        return *this;
+      }
+    }
+    promote();
+    if ( other.is_small() ) {
+      *big_ *= long(other.small_);
+    } else {
+      *big_ *= *other.big_;
+    }
+    normalize();
+    return *this;
+  }
+
+  /**
+   * @brief Truncating division, as for mpz_class
+   */
+  Checked_integer& operator/= (const Checked_integer& other) {
+    if ( is_small() && other.is_small() ) {
+      if ( ! ( small_ == std::numeric_limits<int64_t>::min() && other.small_ == -1 ) ) {
+        small_ /= other.small_;
+        return *this;
+      }
+    }
+    promote();
+    if ( other.is_small() ) {
+      *big_ /= long(other.small_);
+    } else {
+      *big_ /= *other.big_;
+    }
+    normalize();
+    return *this;
+  }
+
+  Checked_integer operator- () const {
+    Checked_integer result;
+    if ( is_small() && small_ != std::numeric_limits<int64_t>::min() ) {
+      result.small_ = -small_;
+    } else {
+      result.set_mpz( -get_mpz() );
+    }
+    return result;
+  }
+
+#ifdef __SIZEOF_INT128__
+  /**
+   * @brief Set the value from a 128 bit integer
+   */
+  void set_int128(const __int128 x) {
+    if ( x >= std::numeric_limits<int64_t>::min() &&
+         x <= std::numeric_limits<int64_t>::max() ) {
+      set_small( int64_t(x) );
+      return;
+    }
+    const bool negative = ( x < 0 );
+    const unsigned __int128 u = negative ? -((unsigned __int128) x) : x;
+    promote();
+    *big_ = (unsigned long) (u >> 64);
+    *big_ <<= 64;
+    *big_ += (unsigned long) u;
+    if ( negative ) {
+      mpz_neg(big_->get_mpz_t(), big_->get_mpz_t());
+    }
+  }
+#endif
+
+private:
+
+  void set_small(const int64_t x) {
+    small_ = x;
+    delete big_;
+    big_ = nullptr;
+  }
+
+  void set_mpz(const mpz_class& x) {
+    if ( x.fits_slong_p() ) {
+      set_small( x.get_si() );
+    } else if ( is_small() ) {
+      big_ = new mpz_class(x);
+    } else {
+      *big_ = x;
+    }
+  }
+
+  /**
+   * @brief Move the value to the mpz_class representation
+   */
+  void promote() {
+    if ( is_small() ) {
+      big_ = new mpz_class( long(small_) );
+    }
+  }
+
+  /**
+   * @brief Move the value back to the fixed-width representation if
+   *        it fits.
+   */
+  void normalize() {
+    if ( big_->fits_slong_p() ) {
+      set_small( big_->get_si() );
+    }
+  }
+
+  int64_t small_;
+  mpz_class* big_;
+};
+
+/**
+ * @brief Three-way comparison
+ *
+ * By the invariant, a value in the mpz_class representation is larger
+ * (or smaller) in absolute value than every value in the fixed-width
+ * representation, so mixed comparisons only need the sign.
+ */
+inline int cmp(const Checked_integer& a, const Checked_integer& b) {
+  if ( a.is_small() ) {
+    if ( b.is_small() ) {
+      return ( a.small_value() > b.small_value() ) - ( a.small_value() < b.small_value() );
+    }
+    return -b.sgn();
+  }
+  if ( b.is_small() ) {
+    return a.sgn();
+  }
+  return ::cmp(a.big_value(), b.big_value());
+}
+
+inline int cmp(const Checked_integer& a, const long b) {
+  if ( a.is_small() ) {
+    return ( a.small_value() > b ) - ( a.small_value() < b );
+  }
+  return a.sgn();
+}
+
+inline bool operator== (const Checked_integer& a, const Checked_integer& b) { return cmp(a, b) == 0; }
+inline bool operator!= (const Checked_integer& a, const Checked_integer& b) { return cmp(a, b) != 0; }
+inline bool operator<  (const Checked_integer& a, const Checked_integer& b) { return cmp(a, b) <  0; }
+inline bool operator>  (const Checked_integer& a, const Checked_integer& b) { return cmp(a, b) >  0; }
+inline bool operator<= (const Checked_integer& a, const Checked_integer& b) { return cmp(a, b) <= 0; }
+inline bool operator>= (const Checked_integer& a, const Checked_integer& b) { return cmp(a, b) >= 0; }
+
+inline bool operator== (const Checked_integer& a, const long b) { return cmp(a, b) == 0; }
+inline bool operator!= (const Checked_integer& a, const long b) { return cmp(a, b) != 0; }
+inline bool operator<  (const Checked_integer& a, const long b) { return cmp(a, b) <  0; }
+inline bool operator>  (const Checked_integer& a, const long b) { return cmp(a, b) >  0; }
+inline bool operator<= (const Checked_integer& a, const long b) { return cmp(a, b) <= 0; }
+inline bool operator>= (const Checked_integer& a, const long b) { return cmp(a, b) >= 0; }
+
+inline Checked_integer operator+ (const Checked_integer& a, const Checked_integer& b) {
+  Checked_integer result (a);
+  result += b;
+  return result;
+}
+
+inline Checked_integer operator- (const Checked_integer& a, const Checked_integer& b) {
+  Checked_integer result (a);
+  result -= b;
+  return result;
+}
+
+inline Checked_integer operator* (const Checked_integer& a, const Checked_integer& b) {
+  Checked_integer result (a);
+  result *= b;
+  return result;
+}
+
+inline Checked_integer operator/ (const Checked_integer& a, const Checked_integer& b) {
+  Checked_integer result (a);
+  result /= b;
+  return result;
+}
+
+inline Checked_integer abs(const Checked_integer& a) {
+  if ( a.sgn() < 0 ) {
+    return -a;
+  }
+  return a;
+}
+
+inline std::ostream& operator<< (std::ostream& out, const Checked_integer& a) {
+  if ( a.is_small() ) {
+    return out << a.small_value();
+  }
+  return out << a.big_value();
+}
+
+//
+// Specializations of the arithmetic helpers in linalg.hpp and
+// standardize_vector.hpp
+//
+
+template <>
+inline void _gcd<Checked_integer>(Checked_integer& a, const Checked_integer& b) {
+  if ( a.is_small() && b.is_small() ) {
+    // compute the gcd of the absolute values in unsigned arithmetic,
+    // since |INT64_MIN| does not fit in an int64_t
+    uint64_t x = ( a.small_value() < 0 ) ? -uint64_t(a.small_value()) : a.small_value();
+    uint64_t y = ( b.small_value() < 0 ) ? -uint64_t(b.small_value()) : b.small_value();
+    while ( y != 0 ) {
+      const uint64_t r = x % y;
+      x = y;
+      y = r;
+    }
+    if ( x <= uint64_t(std::numeric_limits<int64_t>::max()) ) {
+      a = long(x);
+      return;
+    }
+  }
+  mpz_class g;
+  mpz_gcd( g.get_mpz_t(), a.get_mpz().get_mpz_t(), b.get_mpz().get_mpz_t() );
+  a = g;
+}
+
+template <>
+inline double _to_double<Checked_integer>(const Checked_integer& a) {
+  return a.get_d();
+}
+
+template <>
+inline Checked_integer _pow<Checked_integer>(const Checked_integer& x, unsigned int n) {
+  mpz_class y;
+  mpz_pow_ui(y.get_mpz_t(), x.get_mpz().get_mpz_t(), n);
+  return Checked_integer(y);
+}
+
+//
+// Specializations for group_parallel_generators in
+// preprocess_generators.hpp
+//
+
+template <>
+struct Is_integral_number<Checked_integer> : std::true_type {};
+
+template <>
+inline std::size_t _hash_number<Checked_integer>(const Checked_integer& x) {
+  // a value is small iff it fits in an int64_t, so equal values take
+  // the same branch
+  if ( x.is_small() ) {
+    return std::size_t(x.small_value());
+  }
+  return _hash_number<mpz_class>(x.big_value());
+}
+
+#ifdef __SIZEOF_INT128__
+
+template <>
+inline void _mul_sub<Checked_integer>( Checked_integer& a,
+                                       const Checked_integer& b,
+                                       const Checked_integer& c,
+                                       const Checked_integer& e )
+{
+  if ( a.is_small() && b.is_small() && c.is_small() && e.is_small() ) {
+    // each product has absolute value at most 2^126, so their
+    // difference cannot overflow
+    a.set_int128( __int128(a.small_value()) * b.small_value()
+                  - __int128(c.small_value()) * e.small_value() );
+    return;
+  }
+  a *= b;
+  a -= c * e;
+}
+
+template <>
+inline void _mul_sub_div<Checked_integer>( Checked_integer& a,
+                                           const Checked_integer& b,
+                                           const Checked_integer& c,
+                                           const Checked_integer& e,
+                                           const Checked_integer& f )
+{
+  if ( a.is_small() && b.is_small() && c.is_small() && e.is_small() && f.is_small() ) {
+    a.set_int128( ( __int128(a.small_value()) * b.small_value()
+                    - __int128(c.small_value()) * e.small_value() )
+                  / f.small_value() );
+    return;
+  }
+  a *= b;
+  a -= c * e;
+  a /= f;
+}
+
+template <>
+inline int sign_of_mul_sub<Checked_integer>( const Checked_integer& a,
+                                             const Checked_integer& b,
+                                             const Checked_integer& c,
+                                             const Checked_integer& e )
+{
+  if ( a.is_small() && b.is_small() && c.is_small() && e.is_small() ) {
+    const __int128 lhs = __int128(a.small_value()) * b.small_value();
+    const __int128 rhs = __int128(c.small_value()) * e.small_value();
+    return ( lhs > rhs ) - ( lhs < rhs );
+  }
+  const int sign = _sign_of_mul_sub_filter( a.get_d(), b.get_d(), c.get_d(), e.get_d() );
+  if ( sign != 2 ) {
+    return sign;
+  }
+  return _sign_of_mul_sub_exact<mpz_class>( a.get_mpz(), b.get_mpz(), c.get_mpz(), e.get_mpz() );
+}
+
+#endif // __SIZEOF_INT128__
+
+/**
+ * The projection onto (c0, c1) runs in int64_t (see
+ * Machine_generator_projection) whenever the generators and c0, c1
+ * are small enough that no partial sum can overflow, which is
+ * checked with the bound d * max|c| * max|g| <= INT64_MAX. Otherwise,
+ * it falls back to the exact generic projection.
+ */
+template <>
+struct Generator_projection<Checked_integer> {
+
+  Generator_projection( const Matrix<Checked_integer>& generators )
+    : generators(generators)
+    , exact(generators)
+    , all_small(true)
+    , max_abs(0)
+    , c0_small(generators.cols())
+    , c1_small(generators.cols())
+    , x_small(generators.rows())
+    , y_small(generators.rows())
+  {
+    Matrix<long> generators_small (generators.rows(), generators.cols());
+    for ( int i = 0; i < generators.rows() && all_small; ++i ) {
+      for ( int r = 0; r < generators.cols(); ++r ) {
+        const Checked_integer& g = generators[i][r];
+        if ( ! g.is_small() || g.small_value() == std::numeric_limits<int64_t>::min() ) {
+          all_small = false;
+          break;
+        }
+        generators_small[i][r] = g.small_value();
+        const uint64_t g_abs = ( g.small_value() < 0 ) ? -uint64_t(g.small_value()) : g.small_value();
+        max_abs = std::max(max_abs, g_abs);
+      }
+    }
+    if ( all_small ) {
+      machine = Machine_generator_projection<long>(generators_small);
+    }
+  }
+
+  int size() const {
+    return generators.rows();
+  }
+
+  template <typename Vector_t>
+  void operator() ( const Vector_t& c0,
+                    const Vector_t& c1,
+                    std::vector<Checked_integer>& x,
+                    std::vector<Checked_integer>& y )
+  {
+    if ( ! ( all_small && load_small(c0, c1) ) ) {
+      exact(c0, c1, x, y);
+      return;
+    }
+    machine.project(c0_small.data(), c1_small.data(), x_small.data(), y_small.data());
+    const int n = generators.rows();
+    for ( int i = 0; i < n; ++i ) {
+      x[i] = x_small[i];
+      y[i] = y_small[i];
+    }
+  }
+
+private:
+
+  /**
+   * @brief Copy c0, c1 to c0_small, c1_small, provided that the int64_t
+   *        projection cannot overflow.
+   */
+  template <typename Vector_t>
+  bool load_small( const Vector_t& c0, const Vector_t& c1 ) {
+    const int d = c0.size();
+    uint64_t max_c = 0;
+    for ( int r = 0; r < d; ++r ) {
+      if ( ! ( c0[r].is_small() && c1[r].is_small() ) ) {
+        return false;
+      }
+      c0_small[r] = c0[r].small_value();
+      c1_small[r] = c1[r].small_value();
+      const uint64_t a = ( c0_small[r] < 0 ) ? -uint64_t(c0_small[r]) : c0_small[r];
+      const uint64_t b = ( c1_small[r] < 0 ) ? -uint64_t(c1_small[r]) : c1_small[r];
+      max_c = std::max(max_c, std::max(a, b));
+    }
+    if ( max_c == 0 || max_abs == 0 ) {
+      return true;
+    }
+    const uint64_t limit = uint64_t(std::numeric_limits<int64_t>::max()) / d;
+    return ( max_c <= limit / max_abs );
+  }
+
+  const Matrix<Checked_integer>& generators;
+  Exact_generator_projection<Checked_integer> exact;
+  bool all_small;
+  uint64_t max_abs;
+  Machine_generator_projection<long> machine;
+  std::vector<long> c0_small;
+  std::vector<long> c1_small;
+  std::vector<long> x_small;
+  std::vector<long> y_small;
+};
+
+//
+// Type conversions
+//
+
+template <>
+struct Type_casting_functor<Checked_integer, long> {
+  long operator() (const Checked_integer& val) const {
+    assert( val.fits_slong_p() );
+    return val.small_value();
+  }
+};
+
+template <>
+struct Type_casting_functor<Checked_integer, double> {
+  double operator() (const Checked_integer& val) const {
+    return val.get_d();
+  }
+};
+
+template <>
+struct Type_casting_functor<Checked_integer, mpz_class> {
+  mpz_class operator() (const Checked_integer& val) const {
+    return val.get_mpz();
+  }
+};
+
+/**
+ * @brief Convert an integral generator matrix to Checked_integer
+ */
+inline void
+checked_integer_matrix ( const Matrix<mpz_class>& generators_mpz,
+                         Matrix<Checked_integer>& generators_out )
+{
+  const int n = generators_mpz.rows();
+  const int d = generators_mpz.cols();
+  generators_out.resize(n, d);
+  for ( int k = 0; k < n; ++k ) {
+    for ( int i = 0; i < d; ++i ) {
+      generators_out[k][i] = generators_mpz[k][i];
+    }
+  }
+}
+
+/**
+ * Rational and floating point generators are scaled to integers with
+ * GMP first, and then converted to Checked_integer.
+ */
+template <>
+inline void
+preprocess_generators<mpq_class, Checked_integer> (
+  const std::vector<std::vector<mpq_class> >& generators_in,
+  Matrix<Checked_integer>& generators_out,
+  Checked_integer& scaling_factor )
+{
+  Matrix<mpz_class> generators_mpz;
+  mpz_class scaling_factor_mpz;
+  preprocess_generators<mpq_class, mpz_class> (generators_in, generators_mpz, scaling_factor_mpz);
+  checked_integer_matrix (generators_mpz, generators_out);
+  scaling_factor = scaling_factor_mpz;
+}
+
+template <>
+inline void
+preprocess_generators<double, Checked_integer> (
+  const std::vector<std::vector<double> >& generators_in,
+  Matrix<Checked_integer>& generators_out,
+  Checked_integer& scaling_factor )
+{
+  Matrix<mpz_class> generators_mpz;
+  mpz_class scaling_factor_mpz;
+  preprocess_generators<double, mpz_class> (generators_in, generators_mpz, scaling_factor_mpz);
+  checked_integer_matrix (generators_mpz, generators_out);
+  scaling_factor = scaling_factor_mpz;
+}
+
+} // namespace zonotope
+
+#endif // CHECKED_INTEGER_HPP_
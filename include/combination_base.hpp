@@ -11,7 +11,7 @@ struct Combination_base {
   typedef Element_container::size_type size_type;
   
   size_type MAX_SIZE;
-  const int MAX_ELEMENT;
+  int MAX_ELEMENT;
   
   /**
    * A sorted stack of up to MAX_SIZE integers in 0..MAX_ELEMENT-1, that
@@ -19,13 +19,13 @@ struct Combination_inverse_container : Combination_base
   /**
    * The generators of the zonotope
    */
-  const std::vector<std::vector<NT> >& generators;
+  const Matrix<NT>& generators;
 
   /**
    * The product of elementary row operation marices to diagonalize
    * transpose(generators[combination])
    */
-  std::vector<std::vector<NT> > inverse;
+  Matrix<NT> inverse;
 
   /**
    * The value of 1 / det(inverse). When k = d,
@@ -35,19 +35,32 @@ struct Combination_inverse_container : Combination_base
   NT determinant;
 
 
-  Combination_inverse_container( const std::vector<std::vector<NT> >& generators,
+  Combination_inverse_container( const Matrix<NT>& generators,
                                  const int MAX_SIZE )
     : Combination_base (MAX_SIZE, generators.size())
     , generators (generators)
-    , inverse (identity_matrix<NT>(generators[0].size()))
+    , inverse (identity_matrix<NT>(generators.cols()))
     , determinant (1)
     { }
 
 
   void extend(const int i) {
-    Combination_base::extend(i);
     update_inverse<NT>(generators, elements, i, inverse, determinant);
+    Combination_base::extend(i);
   }
+
+  /**
+   * @brief true iff generator i is in the span of the combination
+   */
+  bool spans(const int i) const {
+    for ( int r = int(size()); r < generators.cols(); ++r ) {
+      if ( dot<NT>(inverse[r], generators[i]) != 0 ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   /**
    * @brief True iff the combination is independent
    */
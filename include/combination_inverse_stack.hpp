@@ -0,0 +1,168 @@
+#ifndef COMBINATION_INVERSE_STACK_HPP_
+#define COMBINATION_INVERSE_STACK_HPP_
+
+#include "linalg.hpp"
+#include "combination_base.hpp"
+#include "fixed_dimension.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace zonotope {
+
+/**
+ * @brief An in-place variant of Combination_inverse_container
+ *
+ * Instead of being copied for every child combination, the container
+ * is extended and retracted in place by traverse_combinations_in_place.
+ * It keeps one preallocated inverse matrix per combination size, all
+ * stacked in a single contiguous Matrix, so extend writes the updated
+ * inverse to the frame above the current one, and retract simply
+ * moves back down. Once the frames are set up,
+ * the traversal performs no heap allocations for number types that
+ * reuse their storage on assignment.
+ *
+ * @tparam D The dimension of the generators, if it is known at compile
+ *           time, or 0 (see fixed_dimension.hpp)
+ */
+template <typename NT, int D = 0>
+struct Combination_inverse_stack : Combination_base
+{
+  /**
+   * The generators of the zonotope
+   */
+  const Matrix<NT>& generators;
+
+  /**
+   * The d-by-d frame k (see frame) is the inverse (in the sense of
+   * Combination_inverse_container) for the first k elements.
+   */
+  Matrix<NT> inverses;
+
+  /**
+   * determinants[k] is the determinant for the first k elements.
+   */
+  std::vector<NT> determinants;
+
+  /**
+   * The determinant of the current combination, or 0 if the last
+   * extension made it singular.
+   */
+  NT determinant;
+
+  /**
+   * Scratch space for update_inverse_into
+   */
+  typename Fixed_vector<NT, D>::type lambda;
+
+  /**
+   * Scratch space for spans
+   */
+  mutable NT product;
+
+  Combination_inverse_stack( const Matrix<NT>& generators,
+                             const int MAX_SIZE )
+    : Combination_base (MAX_SIZE, generators.size())
+    , generators (generators)
+    , inverses ((MAX_SIZE + 1) * generators.cols(), generators.cols(), NT(0))
+    , determinants (MAX_SIZE + 1, NT(1))
+    , determinant (1)
+  {
+    Fixed_vector<NT, D>::resize(lambda, generators.cols());
+    for ( int i = 0; i < dimension(); ++i ) {
+      inverses[i][i] = 1;
+    }
+    elements.reserve(MAX_SIZE);
+  }
+
+  /**
+   * @brief Make this the empty combination of the generators again,
+   *        after the dimensions of the generators have changed.
+   *
+   * The frames are reallocated only if they have to grow, so
+   * resetting a stack between zonotopes of the same size performs no
+   * heap allocations.
+   */
+  void reset( const int MAX_SIZE ) {
+    const int d = dimension();
+    this->MAX_SIZE = MAX_SIZE;
+    MAX_ELEMENT = generators.size();
+    elements.clear();
+    elements.reserve(MAX_SIZE);
+    inverses.resize((MAX_SIZE + 1) * d, d);
+    // only frame 0 is read before it is written
+    for ( int i = 0; i < d; ++i ) {
+      for ( int j = 0; j < d; ++j ) {
+        inverses[i][j] = ( i == j ) ? 1 : 0;
+      }
+    }
+    determinants.resize(MAX_SIZE + 1);
+    determinants[0] = 1;
+    determinant = 1;
+    Fixed_vector<NT, D>::resize(lambda, d);
+  }
+
+  int dimension() const {
+    return ( D > 0 ) ? D : generators.cols();
+  }
+
+  /**
+   * @brief The inverse for the first k elements
+   */
+  Matrix_view<NT> frame(const int k) {
+    return inverses.block(k * dimension(), dimension());
+  }
+
+  Matrix_view<const NT> frame(const int k) const {
+    return inverses.block(k * dimension(), dimension());
+  }
+
+  void extend(const int i) {
+    const int k = size();
+    if ( update_inverse_into<NT, D>( generators[i], k,
+                                     frame(k), determinants[k],
+                                     frame(k+1), determinants[k+1],
+                                     lambda ) ) {
+      determinant = determinants[k+1];
+    } else {
+      determinant = 0;
+    }
+    Combination_base::extend(i);
+  }
+
+  /**
+   * @brief Undo the last call to extend
+   */
+  void retract() {
+    elements.pop_back();
+    determinant = determinants[size()];
+  }
+
+  /**
+   * @brief true iff generator i is in the span of the combination
+   *
+   * That is the case iff the rows k..d-1 of the current frame are
+   * orthogonal to it (see update_inverse_into).
+   */
+  bool spans(const int i) const {
+    const int k = size();
+    const Matrix_view<const NT> inverse = frame(k);
+    for ( int r = k; r < dimension(); ++r ) {
+      if ( ! _is_orthogonal<NT, D>(inverse[r], generators[i], product) ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief True iff the combination is independent
+   */
+  bool is_valid() const {
+    return ( determinant != 0 );
+  }
+};
+
+} // namespace zonotope
+
+#endif // COMBINATION_INVERSE_STACK_HPP_
@@ -19,30 +19,74 @@ struct Combination_kernel_container : Combination_base
   /**
    * The generators of the zonotope
    */
-  const std::vector<std::vector<NT> >& generators;
+  const Matrix<NT>& generators;
 
   /**
-   * The kernel of generators[combination]
+   * The first kernel_size rows are a basis of the kernel of
+   * generators[combination]
    */
-  std::vector<std::vector<NT> > kernel;
+  Matrix<NT> kernel;
 
-  Combination_kernel_container( const std::vector<std::vector<NT> >& generators,
+  int kernel_size;
+
+  Combination_kernel_container( const Matrix<NT>& generators,
                                 const int MAX_SIZE )
     : Combination_base (MAX_SIZE, generators.size())
     , generators (generators)
-    , kernel (identity_matrix<NT>(generators[0].size()))
+    , kernel (identity_matrix<NT>(generators.cols()))
+    , kernel_size (generators.cols())
     { }
 
   void extend(const int i) {
     Combination_base::extend(i);
-    update_kernel<NT>(kernel, generators[i]);
+    update_kernel<NT>(kernel, kernel_size, generators[i]);
   }
   
+  /**
+   * @brief The i-th vector of the current kernel basis
+   */
+  typename Matrix<NT>::Const_row_t kernel_row(const int i) const {
+    return kernel[i];
+  }
+
+  /**
+   * @brief true iff v is in the span of the first k elements
+   *
+   * Unlike Combination_kernel_stack, this container does not keep the
+   * kernels of the prefixes, so the kernel is computed from scratch.
+   */
+  template <typename Vector_t>
+  bool prefix_spans(const int k, const Vector_t& v) const {
+    Matrix<NT> prefix_kernel = identity_matrix<NT>(generators.cols());
+    int prefix_kernel_size = generators.cols();
+    for ( int i = 0; i < k; ++i ) {
+      update_kernel<NT>(prefix_kernel, prefix_kernel_size, generators[elements[i]]);
+    }
+    for ( int r = 0; r < prefix_kernel_size; ++r ) {
+      if ( dot<NT>(prefix_kernel[r], v) != 0 ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief true iff generator i is in the span of the combination
+   */
+  bool spans(const int i) const {
+    for ( int r = 0; r < kernel_size; ++r ) {
+      if ( dot<NT>(kernel[r], generators[i]) != 0 ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   /**
    * @brief True iff the combination is independent
    */
   bool is_valid() const {
-    return ( (size() + kernel.size()) == generators[0].size() );
+    return ( (int(size()) + kernel_size) == generators.cols() );
   }
 
 };
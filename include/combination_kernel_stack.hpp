@@ -0,0 +1,144 @@
+#ifndef COMBINATION_KERNEL_STACK_HPP_
+#define COMBINATION_KERNEL_STACK_HPP_
+
+#include "linalg.hpp"
+#include "combination_base.hpp"
+#include "fixed_dimension.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace zonotope {
+
+/**
+ * @brief An in-place variant of Combination_kernel_container
+ *
+ * Like Combination_inverse_stack, it keeps one preallocated kernel
+ * basis per combination size, which extend writes to and retract
+ * moves back from, so that the traversal performs no heap allocations
+ * once the frames are set up.
+ *
+ * @tparam D The dimension of the generators, if it is known at compile
+ *           time, or 0 (see fixed_dimension.hpp)
+ */
+template <typename NT, int D = 0>
+struct Combination_kernel_stack : Combination_base
+{
+  /**
+   * The generators of the zonotope
+   */
+  const Matrix<NT>& generators;
+
+  /**
+   * The first (d-k) rows of the d-by-d frame k (see frame) are a basis
+   * of the kernel of the first k elements.
+   */
+  Matrix<NT> kernels;
+
+  /**
+   * false iff the last extension was dependent
+   */
+  bool independent;
+
+  /**
+   * Scratch space for update_kernel_into
+   */
+  typename Fixed_vector<NT, D>::type x;
+  NT gcd;
+
+  /**
+   * Scratch space for prefix_spans
+   */
+  mutable NT product;
+
+  Combination_kernel_stack( const Matrix<NT>& generators,
+                            const int MAX_SIZE )
+    : Combination_base (MAX_SIZE, generators.size())
+    , generators (generators)
+    , kernels ((MAX_SIZE + 1) * generators.cols(), generators.cols(), NT(0))
+    , independent (true)
+  {
+    Fixed_vector<NT, D>::resize(x, generators.cols());
+    for ( int i = 0; i < dimension(); ++i ) {
+      kernels[i][i] = 1;
+    }
+    elements.reserve(MAX_SIZE);
+  }
+
+  int dimension() const {
+    return ( D > 0 ) ? D : generators.cols();
+  }
+
+  /**
+   * @brief The kernel basis for the first k elements
+   */
+  Matrix_view<NT> frame(const int k) {
+    return kernels.block(k * dimension(), dimension());
+  }
+
+  Matrix_view<const NT> frame(const int k) const {
+    return kernels.block(k * dimension(), dimension());
+  }
+
+  void extend(const int i) {
+    const int k = size();
+    independent = update_kernel_into<NT, D>( frame(k), dimension() - k,
+                                             generators[i], frame(k+1),
+                                             x, gcd );
+    Combination_base::extend(i);
+  }
+
+  /**
+   * @brief Undo the last call to extend
+   */
+  void retract() {
+    elements.pop_back();
+    independent = true;
+  }
+
+  /**
+   * @brief The number of vectors in the current kernel basis
+   */
+  int kernel_size() const {
+    return dimension() - size();
+  }
+
+  /**
+   * @brief The i-th vector of the current kernel basis
+   */
+  Vector_view<const NT> kernel_row(const int i) const {
+    return frame(size())[i];
+  }
+
+  /**
+   * @brief true iff v is in the span of the first k elements
+   */
+  template <typename Vector_t>
+  bool prefix_spans(const int k, const Vector_t& v) const {
+    const Matrix_view<const NT> kernel = frame(k);
+    for ( int r = 0; r < dimension() - k; ++r ) {
+      if ( ! _is_orthogonal<NT, D>(kernel[r], v, product) ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief true iff generator i is in the span of the combination
+   */
+  bool spans(const int i) const {
+    return prefix_spans(size(), generators[i]);
+  }
+
+  /**
+   * @brief True iff the combination is independent
+   */
+  bool is_valid() const {
+    return independent;
+  }
+};
+
+} // namespace zonotope
+
+#endif // COMBINATION_KERNEL_STACK_HPP_
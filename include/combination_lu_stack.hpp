@@ -0,0 +1,238 @@
+#ifndef COMBINATION_LU_STACK_HPP_
+#define COMBINATION_LU_STACK_HPP_
+
+#include "matrix.hpp"
+#include "combination_base.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace zonotope {
+
+/**
+ * @brief A floating-point variant of Combination_inverse_stack, which
+ *        tracks the absolute determinant of the combination by
+ *        Gaussian elimination with partial pivoting.
+ *
+ * Row k of the stack is generator k of the combination, reduced
+ * against rows 0..k-1, and its pivot is the entry of largest absolute
+ * value. The absolute determinant of the first k elements is the
+ * product of their pivots, so extending costs O(k*d) operations, and
+ * retracting is free.
+ *
+ * Along with the determinant, the stack keeps a first-order estimate
+ * of its rounding error. Elimination with partial pivoting is backward
+ * stable: the computed pivots are the exact ones of a perturbed matrix,
+ * whose row j moves by at most about d*u*rho*|g_j|. Here u is the unit
+ * roundoff and rho is the growth of the reduced rows over the original
+ * ones. The determinant is multilinear in the rows, so its error is at
+ * most about d*(d+2)*u*rho times the Hadamard bound prod_j |g_j|.
+ *
+ * A pivot below its own error estimate is treated as zero, which prunes
+ * the subtree of the combination. The combinations that are dropped
+ * this way are not exactly singular in general. pruned_error_bound
+ * therefore sums the largest volume they can contribute within the
+ * same error model.
+ */
+template <typename NT>
+struct Combination_lu_stack : Combination_base
+{
+  /**
+   * The generators of the zonotope
+   */
+  const Matrix<NT>& generators;
+
+  /**
+   * Row k is generator k of the combination, reduced against the rows
+   * above it.
+   */
+  Matrix<NT> rows;
+
+  /**
+   * pivot_columns[k] is the column of the pivot of row k
+   */
+  std::vector<int> pivot_columns;
+
+  /**
+   * determinants[k] is the absolute determinant of the first k
+   * elements, and norm_products[k] the product of their norms.
+   */
+  std::vector<NT> determinants;
+  std::vector<NT> norm_products;
+
+  /**
+   * growth[k] is the largest ratio of the largest absolute entry of a
+   * reduced row to that of its generator, over the first k rows (at
+   * least 1)
+   */
+  std::vector<NT> growth;
+
+  /**
+   * The absolute determinant of the current combination, or 0 if the
+   * last extension made it singular.
+   */
+  NT determinant;
+
+  /**
+   * The estimated bound on the error of determinant, and
+   * error_bounds[k] that of determinants[k]
+   */
+  NT error_bound;
+  std::vector<NT> error_bounds;
+
+  /**
+   * The accumulated bound on the volume of all the combinations that
+   * were pruned as singular
+   */
+  NT pruned_error_bound;
+
+  Combination_lu_stack( const Matrix<NT>& generators,
+                        const int MAX_SIZE )
+    : Combination_base (MAX_SIZE, generators.size())
+    , generators (generators)
+    , rows (MAX_SIZE, generators.cols(), NT(0))
+    , pivot_columns (MAX_SIZE, 0)
+    , determinants (MAX_SIZE + 1, NT(1))
+    , norm_products (MAX_SIZE + 1, NT(1))
+    , growth (MAX_SIZE + 1, NT(1))
+    , determinant (1)
+    , error_bound (0)
+    , error_bounds (MAX_SIZE + 1, NT(0))
+    , pruned_error_bound (0)
+    , generator_norms_ (generators.size())
+    , generator_max_abs_ (generators.size())
+    , max_norm_ (0)
+  {
+    const int d = dimension();
+    for ( int i = 0; i < int(generators.size()); ++i ) {
+      NT squared_norm = 0;
+      NT max_abs = 0;
+      for ( int j = 0; j < d; ++j ) {
+        squared_norm += generators[i][j] * generators[i][j];
+        max_abs = std::max(max_abs, NT(std::abs(generators[i][j])));
+      }
+      generator_norms_[i] = std::sqrt(squared_norm);
+      generator_max_abs_[i] = max_abs;
+      max_norm_ = std::max(max_norm_, generator_norms_[i]);
+    }
+    elements.reserve(MAX_SIZE);
+  }
+
+  int dimension() const {
+    return generators.cols();
+  }
+
+  void extend(const int i) {
+    const int k = size();
+    const int d = dimension();
+    const NT u = std::numeric_limits<NT>::epsilon() / 2;
+
+    auto row = rows[k];
+    for ( int j = 0; j < d; ++j ) {
+      row[j] = generators[i][j];
+    }
+
+    // eliminate the pivot columns of the rows above
+    for ( int r = 0; r < k; ++r ) {
+      const auto pivot_row = rows[r];
+      const int p = pivot_columns[r];
+      const NT factor = row[p] / pivot_row[p];
+      if ( factor != 0 ) {
+        for ( int j = 0; j < d; ++j ) {
+          row[j] -= factor * pivot_row[j];
+        }
+      }
+      row[p] = 0;
+    }
+
+    // partial pivoting
+    int p = 0;
+    NT pivot_abs = 0;
+    for ( int j = 0; j < d; ++j ) {
+      const NT x = std::abs(row[j]);
+      if ( x > pivot_abs ) {
+        pivot_abs = x;
+        p = j;
+      }
+    }
+    pivot_columns[k] = p;
+
+    NT row_growth = 1;
+    if ( generator_max_abs_[i] > 0 ) {
+      row_growth = std::max(row_growth, pivot_abs / generator_max_abs_[i]);
+    }
+    growth[k+1] = std::max(growth[k], row_growth);
+    determinants[k+1] = determinants[k] * pivot_abs;
+    norm_products[k+1] = norm_products[k] * generator_norms_[i];
+    error_bounds[k+1] = d * (d + 2) * u * growth[k+1] * norm_products[k+1];
+
+    const NT pivot_tolerance = 4 * d * u * growth[k+1] * generator_norms_[i];
+    if ( pivot_abs <= pivot_tolerance ) {
+      // every completion of the pruned combination has an absolute
+      // determinant of at most about determinants[k] * pivot_tolerance
+      // * max_norm_^(d-k-1)
+      const int remaining = int(MAX_SIZE) - k - 1;
+      pruned_error_bound += _num_combinations(MAX_ELEMENT - 1 - i, remaining)
+        * determinants[k] * pivot_tolerance * std::pow(max_norm_, remaining);
+      determinant = 0;
+      error_bound = 0;
+    } else {
+      determinant = determinants[k+1];
+      error_bound = error_bounds[k+1];
+    }
+    Combination_base::extend(i);
+  }
+
+  /**
+   * @brief Undo the last call to extend
+   */
+  void retract() {
+    elements.pop_back();
+    determinant = determinants[size()];
+    error_bound = error_bounds[size()];
+  }
+
+  /**
+   * @brief Always false: a rounded elimination cannot decide whether a
+   *        generator is in the span.
+   *
+   * The traversal then tries every extension, so that each pruned one
+   * still adds to pruned_error_bound.
+   */
+  bool spans(const int) const {
+    return false;
+  }
+
+  /**
+   * @brief True iff the combination is independent
+   */
+  bool is_valid() const {
+    return ( determinant != 0 );
+  }
+
+private:
+
+  /**
+   * @brief The binomial coefficient C(n, k), as a floating-point number
+   */
+  static NT _num_combinations(const int n, const int k) {
+    if ( k < 0 || k > n ) {
+      return 0;
+    }
+    NT result = 1;
+    for ( int j = 1; j <= k; ++j ) {
+      result = result * (n - k + j) / j;
+    }
+    return result;
+  }
+
+  std::vector<NT> generator_norms_;
+  std::vector<NT> generator_max_abs_;
+  NT max_norm_;
+};
+
+} // namespace zonotope
+
+#endif // COMBINATION_LU_STACK_HPP_
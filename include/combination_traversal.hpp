@@ -2,17 +2,156 @@
 #define COMBINATION_TRAVERSAL_HPP_
 
 #include <algorithm>
+#include <cstddef>
 #include <vector>
 #include <iostream>
 
 namespace zonotope {
 
+/**
+ * @brief Counts of the work done by a combination traversal
+ */
+struct Combination_traversal_statistics {
+  /**
+   * The number of combinations passed to the output functor
+   */
+  long num_combinations;
+
+  /**
+   * The number of extensions that were skipped without calling
+   * extend, because the element was known to be in the span of the
+   * combination. Each of them is a pruned subtree.
+   */
+  long num_pruned_subtrees;
+
+  Combination_traversal_statistics()
+    : num_combinations(0)
+    , num_pruned_subtrees(0)
+    { }
+
+  Combination_traversal_statistics& operator+= (
+    const Combination_traversal_statistics& other )
+  {
+    num_combinations += other.num_combinations;
+    num_pruned_subtrees += other.num_pruned_subtrees;
+    return *this;
+  }
+};
+
+/**
+ * @brief The elements that are in the span of the current combination
+ *        of a traversal.
+ *
+ * An element in the span of a combination is also in the span of every
+ * combination below it, so it is marked once and skipped in the whole
+ * subtree, instead of being passed to a failing extend at every node.
+ * The marks are kept on a stack and undone when the traversal leaves
+ * the combination that made them.
+ */
+struct Combination_span_marks {
+  std::vector<char> is_marked;
+  std::vector<int> marked;
+
+  Combination_span_marks() { }
+
+  explicit Combination_span_marks( const int num_elements ) {
+    reset(num_elements);
+  }
+
+  /**
+   * @brief Clear the marks for elements in 0..num_elements-1, which
+   *        allocates only if num_elements is larger than before
+   */
+  void reset( const int num_elements ) {
+    is_marked.assign(num_elements, 0);
+    marked.clear();
+    marked.reserve(num_elements);
+  }
+
+  /**
+   * @brief Mark the unmarked elements after back() that the combination
+   *        spans, with the container query `spans(i)`.
+   *
+   * This is skipped when the children of the combination cannot be
+   * extended any further, because then there is no subtree left to
+   * prune, and a failing extend is no more expensive than the query.
+   *
+   * @return The number of marks to restore with unmark
+   */
+  template <typename Combination_container>
+  std::size_t mark( const Combination_container& combination ) {
+    const std::size_t num_marked = marked.size();
+    if ( combination.size() + 2 > combination.MAX_SIZE ) {
+      return num_marked;
+    }
+    for ( int i = combination.next_elements_begin();
+          i < combination.MAX_ELEMENT;
+          ++i )
+    {
+      if ( ! is_marked[i] && combination.spans(i) ) {
+        is_marked[i] = 1;
+        marked.push_back(i);
+      }
+    }
+    return num_marked;
+  }
+
+  void unmark( const std::size_t num_marked ) {
+    while ( marked.size() > num_marked ) {
+      is_marked[marked.back()] = 0;
+      marked.pop_back();
+    }
+  }
+};
+
+template <typename Combination_container,
+          typename Output_functor>
+void _traverse_combinations (
+  const Combination_container& current_combination,
+  Output_functor& output,
+  Combination_span_marks& marks,
+  Combination_traversal_statistics* statistics )
+{
+  if ( statistics ) {
+    ++statistics->num_combinations;
+  }
+  if ( output(current_combination) ) {
+    // the current combination is a leaf and has been handled
+    return;
+  }
+
+  const std::size_t num_marked = marks.mark(current_combination);
+  for ( int i = current_combination.next_elements_begin();
+        i < current_combination.next_elements_end();
+        ++i )
+  {
+    if ( marks.is_marked[i] ) {
+      if ( statistics ) {
+        ++statistics->num_pruned_subtrees;
+      }
+      continue;
+    }
+    Combination_container child_combination( current_combination );
+    child_combination.extend(i);
+    if ( child_combination.is_valid() ) {
+      _traverse_combinations(child_combination, output, marks, statistics);
+    }
+  }
+  marks.unmark(num_marked);
+}
+
 /**
  * @brief A generic depth-first combination traversal algorithm.
  *
+ * The extensions by elements in the span of an ancestor combination are
+ * skipped without calling extend (see Combination_span_marks).
+ *
  * @tparam Combination_container A container type for combinations. It
  *                               should implement at least all the
- *                               same interface as Combination_base.
+ *                               same interface as Combination_base,
+ *                               and `spans(i)`, which is true only if
+ *                               element i is in the span of the
+ *                               combination.
  * 
  * @tparam Output_functor A functor type that decides what to do with
  *                        the combinations traversed (it could, for
@@ -21,31 +160,94 @@ namespace zonotope {
  *
  * @param current_combination The root of the current traversal subtree
  *
- * @param max_size A tight upper bound on the allowed size of a combination
- *
  * @param output The output functor.
+ *
+ * @param statistics If set, the counts of the traversal are added to it.
  */
 template <typename Combination_container,
           typename Output_functor>
 void traverse_combinations (
   const Combination_container& current_combination,
-  Output_functor& output)
+  Output_functor& output,
+  Combination_traversal_statistics* statistics = nullptr )
+{
+  Combination_span_marks marks (current_combination.MAX_ELEMENT);
+  _traverse_combinations(current_combination, output, marks, statistics);
+}
+
+/**
+ * @brief traverse_combinations_in_place with storage for the marks,
+ *        which can be reused from one traversal to the next. It must
+ *        be empty (see Combination_span_marks::reset) and have room
+ *        for MAX_ELEMENT elements.
+ */
+template <typename Combination_container,
+          typename Output_functor>
+void traverse_combinations_in_place (
+  Combination_container& current_combination,
+  Output_functor& output,
+  Combination_span_marks& marks,
+  Combination_traversal_statistics* statistics = nullptr )
 {
+  if ( statistics ) {
+    ++statistics->num_combinations;
+  }
   if ( output(current_combination) ) {
     // the current combination is a leaf and has been handled
     return;
   }
 
-  for ( int i = current_combination.next_elements_begin();
-        i < current_combination.next_elements_end();
-        ++i )
-  {
-    Combination_container child_combination( current_combination );
-    child_combination.extend(i);
-    if ( child_combination.is_valid() ) {
-      traverse_combinations(child_combination, output);
+  const int begin = current_combination.next_elements_begin();
+  const int end = current_combination.next_elements_end();
+
+  const std::size_t num_marked = marks.mark(current_combination);
+  for ( int i = begin; i < end; ++i ) {
+    if ( marks.is_marked[i] ) {
+      if ( statistics ) {
+        ++statistics->num_pruned_subtrees;
+      }
+      continue;
     }
+    current_combination.extend(i);
+    if ( current_combination.is_valid() ) {
+      traverse_combinations_in_place(current_combination, output, marks, statistics);
+    }
+    current_combination.retract();
   }
+  marks.unmark(num_marked);
+}
+
+/**
+ * @brief A depth-first combination traversal that modifies a single
+ *        container in place.
+ *
+ * Same as traverse_combinations, but instead of copying the container
+ * for every child, it calls `extend(i)` on the container before
+ * visiting the child, and `retract()` afterwards.
+ *
+ * @tparam Combination_container A container type like
+ *                               Combination_inverse_stack, which in
+ *                               addition to the interface of
+ *                               Combination_base and `spans(i)`
+ *                               implements retract() to undo the last
+ *                               extend().
+ *
+ * @param current_combination The root of the current traversal
+ *                            subtree. It is restored on return.
+ *
+ * @param output The output functor.
+ *
+ * @param statistics If set, the counts of the traversal are added to it.
+ */
+template <typename Combination_container,
+          typename Output_functor>
+void traverse_combinations_in_place (
+  Combination_container& current_combination,
+  Output_functor& output,
+  Combination_traversal_statistics* statistics = nullptr )
+{
+  Combination_span_marks marks (current_combination.MAX_ELEMENT);
+  traverse_combinations_in_place(current_combination, output, marks, statistics);
 }
 
 } // namespace zonotope
@@ -1,6 +1,8 @@
 #ifndef COMPARE_BY_ANGLE_HPP_
 #define COMPARE_BY_ANGLE_HPP_
 
+#include "filtered_predicates.hpp"
+
 /**
  *  Compare two points by angle in `[0, 2*pi)`
  */
@@ -37,7 +39,7 @@ inline bool compare_by_angle ( const Point_2& a, const Point_2& b ) {
     return false;
   }
   // both points lie on the same side of the x-axis
-  return a.y * b.x < a.x * b.y ;
+  return zonotope::sign_of_mul_sub(a.y, b.x, a.x, b.y) < 0;
 }
 
 #endif // COMPARE_BY_ANGLE_HPP_
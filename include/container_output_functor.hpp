@@ -16,6 +16,42 @@ struct Container_output_functor {
   }
 };
 
+/**
+ * @brief Like Container_output_functor, but appends to a sequence
+ *        container (e.g. a std::vector buffer) with push_back.
+ */
+template <typename Container_t, typename Input_t, typename Output_t = Input_t>
+struct Sequence_output_functor {
+  Container_t& data;
+  Type_casting_functor<Input_t, Output_t> Cast_type;
+
+  Sequence_output_functor(Container_t& data) : data(data) {}
+
+  bool operator() (const Input_t& val) {
+    data.push_back( Cast_type(val) );
+    return true;
+  }
+};
+
+/**
+ * @brief Forwards every value to a sink functor, `sink(value)`, and
+ *        counts them.
+ */
+template <typename Sink_t, typename Input_t, typename Output_t = Input_t>
+struct Sink_output_functor {
+  Sink_t& sink;
+  long count;
+  Type_casting_functor<Input_t, Output_t> Cast_type;
+
+  Sink_output_functor(Sink_t& sink) : sink(sink), count(0) {}
+
+  bool operator() (const Input_t& val) {
+    sink( Cast_type(val) );
+    ++count;
+    return true;
+  }
+};
+
 } // namespace zonotope
 
 #endif // CONTAINER_OUTPUT_FUNCTOR_HPP_
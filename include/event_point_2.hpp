@@ -5,6 +5,9 @@
 #include "linalg.hpp"
 #include "hyperplane.hpp"
 #include "compare_by_angle.hpp"
+#include "generator_projection.hpp"
+#include "angular_sort.hpp"
+#include "matrix.hpp"
 
 #include <algorithm>
 #include <vector>
@@ -42,89 +45,183 @@ struct Event_point_2 {
 
 };
 
+/**
+ * @brief Reusable structure-of-arrays storage for handle_event_points
+ *
+ * Holds the projections of all generators onto the plane of the
+ * current ridge, and the event points as indices into them, so that
+ * neither the numbers nor the events are reallocated (or, for the
+ * exact number types, copied) for every ridge. An output functor
+ * keeps one buffer for the whole traversal.
+ */
+template <typename Number_t>
+struct Event_point_buffer {
+
+  /**
+   * Projects the generators onto the plane (c0, c1)
+   */
+  Generator_projection<Number_t> projection;
+
+  /**
+   * The planar coordinates of generators[i] are (x[i], y[i])
+   */
+  std::vector<Number_t> x;
+  std::vector<Number_t> y;
+
+  /**
+   * The event 2*i is generators[i] and the event 2*i+1 is
+   * -generators[i]. Of each nontrivial pair of events, only the one
+   * in the upper half-plane is listed (see Angular_sort).
+   */
+  std::vector<int> events;
+
+  /**
+   * Sorts the events
+   */
+  Angular_sort<Number_t> angular_sort;
+
+  /**
+   * A vector that projects to the inequality offset
+   */
+  std::vector<Number_t> offset_vector;
+
+  Event_point_buffer( const Matrix<Number_t>& generators )
+    : projection( generators )
+    , x( generators.rows() )
+    , y( generators.rows() )
+    , offset_vector( generators.cols() )
+  {
+    events.reserve( generators.rows() );
+  }
+};
+
 /**
  * @brief Handle the last step of the zonotope H-rep. construction (the planar view)
+ *
+ * Every oriented facet of the zonotope is output exactly once over all
+ * the (d-2)-combinations, namely for the combination and event i such
+ * that [combination, i] is the lexicographically first basis of the
+ * generators in the facet hyperplane (the one the greedy algorithm
+ * picks). For the current combination, that holds iff
+ *
+ * - i > largest_index,
+ * - i is the smallest index among the events with the same angle
+ *   (the other generators in the hyperplane that are not in the span
+ *   of the combination), and
+ * - every generator j < i outside the combination that projects to
+ *   the origin (i.e. is in the span of the combination) is spanned
+ *   by the elements of the combination that are smaller than j.
+ *
+ * For generators in general position, the last two conditions always
+ * hold, and only the first one matters.
+ *
+ * @param largest_index The largest index of the current combination.
+ *
+ * @param c0, c1 A basis of the kernel of the current combination
+ *
+ * @param spanned_by_smaller A predicate such that
+ *                           `spanned_by_smaller(j)` is true iff j is in
+ *                           the combination, or generators[j] is in the
+ *                           span of the elements smaller than j. It is
+ *                           only called for generators that project to
+ *                           the origin.
+ *
+ * @param buffer Storage that is reused from call to call
  */
 template <typename Number_t,
-          typename Vector_t,
-          typename Generator_container,
+          typename Kernel_vector_t,
+          typename Spanned_by_smaller_predicate,
           typename Halfspaces_output_functor,
           typename Hyperplane_t = Hyperplane<Number_t> >
 inline void handle_event_points (
   const int largest_index,
-  const std::vector<int>& current_combination,
-  const Vector_t& c0,
-  const Vector_t& c1,
-  const Generator_container& generators,
+  const Kernel_vector_t& c0,
+  const Kernel_vector_t& c1,
+  const Matrix<Number_t>& generators,
+  const Spanned_by_smaller_predicate& spanned_by_smaller,
+  Event_point_buffer<Number_t>& buffer,
   Halfspaces_output_functor& output_fn )
 {
-  using std::vector;
-
-  const int n = generators.size();
-  const int d = generators[0].size();
-
-  // A vector that projects to the inequality offset
-  Vector_t offset_vector( d );
-
-  // The event points in the plane spanned by c0, c1
-  vector<Event_point_2<Number_t> > event_points;
-
-
-  // construct a boolean map of the combination for faster
-  // membership lookup
-  vector<bool> is_elem(n, false);
-  for ( int i : current_combination ) {
-    is_elem[i] = true;
+  const int n = generators.rows();
+  const int d = generators.cols();
+
+  std::vector<Number_t>& x = buffer.x;
+  std::vector<Number_t>& y = buffer.y;
+  std::vector<int>& events = buffer.events;
+  std::vector<Number_t>& offset_vector = buffer.offset_vector;
+
+  // Project all generators to the plane spanned by c0, c1 in one
+  // pass. The generators in the current combination project to the
+  // origin, so they produce no events.
+  buffer.projection( c0, c1, x, y );
+
+  events.clear();
+  for ( int r = 0; r < d; ++r ) {
+    offset_vector[r] = 0;
   }
 
-  // Generate the event points
+  // The events with indices first_excluded or larger would duplicate
+  // facets that are output for a different combination
+  int first_excluded = n;
+
+  // Generate the event points in the upper half-plane. Their
+  // negations are exactly the event points in the lower half-plane.
   for ( int i = 0; i < n; ++i ) {
-    if ( is_elem[i] ) {
-      // i is in the current combination, so it generators[i] projects to the
-      // origin in the plane spanned by c0, c1.
-      continue;
-    }
-    // i is in the complementary combination
-    const Vector_t& v = generators[i];
-    const Number_t x = dot<Number_t>( c0, v );
-    const Number_t y = dot<Number_t>( c1, v );
-
-    if ( x != 0 || y != 0 ) {
-      // i corresponds to a nontrivial event
-      event_points.push_back( Event_point_2<Number_t> ( i,  1,  x,  y ) );
-      event_points.push_back( Event_point_2<Number_t> ( i, -1, -x, -y ) );
-
-      if ( y < 0 || ( y == 0 && x < 0 ) ) {
-        // v = generators[i] is below the x-axis
-        for ( int r = 0; r < d; ++r ) {
-          offset_vector[r] += v[r];
-        }
+    if ( y[i] < 0 || ( y[i] == 0 && x[i] < 0 ) ) {
+      // v = generators[i] is below the x-axis
+      events.push_back( 2*i + 1 );
+      const auto& v = generators[i];
+      for ( int r = 0; r < d; ++r ) {
+        offset_vector[r] += v[r];
       }
+    } else if ( x[i] != 0 || y[i] != 0 ) {
+      events.push_back( 2*i );
+    } else if ( first_excluded == n && ! spanned_by_smaller(i) ) {
+      // i corresponds to a trivial event, and the greedy basis of any
+      // facet through the combination would contain it
+      first_excluded = i;
     }
   }
 
-  std::sort ( event_points.begin(), event_points.end() );
-  // The event points are sorted in counterclockwise order around the origin,
-  // by angle in [0, 2*pi)
+  buffer.angular_sort( x, y, events );
+  // The event points are sorted in counterclockwise order around the
+  // origin, by angle in [0, pi). The same order with every event
+  // negated covers the angles in [pi, 2*pi).
 
   // Rotate a halfplane in counterclockwise order round the origin
   // The initial halfplane is everything below the x-axis, and offset_vector
   // is the sum of those generators.
-  for ( const auto& event : event_points ) {
-    int i = event.generator_index;
-    
-    for ( int r = 0; r < d; ++r ) {
-      offset_vector[r] += event.sign * generators[i][r];
-    }
-    if ( i > largest_index ) {
-      Hyperplane_t h (d);
+  const int num_events = events.size();
+  for ( int half = 0; half < 2; ++half ) {
+    for ( int position = 0; position < num_events; ++position ) {
+      const int upper_event = events[position];
+      const int event = ( half == 0 ) ? upper_event : ( upper_event ^ 1 );
+      const int i = event >> 1;
+      const bool negated = ( event & 1 );
+      const auto& v = generators[i];
+
       for ( int r = 0; r < d; ++r ) {
-        h.normal[r] = -event.y * c0[r] + event.x * c1[r];
+        if ( negated ) {
+          offset_vector[r] -= v[r];
+        } else {
+          offset_vector[r] += v[r];
+        }
       }
-      standardize_vector<Number_t, Vector_t> ( h.normal );
+      if ( i > largest_index &&
+           i < first_excluded &&
+           buffer.angular_sort.starts_angle(position) ) {
+        Hyperplane_t h (d);
+        for ( int r = 0; r < d; ++r ) {
+          h.normal[r] = -y[i] * c0[r] + x[i] * c1[r];
+          if ( negated ) {
+            h.normal[r] = -h.normal[r];
+          }
+        }
+        standardize_vector<Number_t> ( h.normal );
 
-      h.offset = -dot<Number_t, Vector_t>(h.normal, offset_vector);
-      output_fn(h);
+        h.offset = -dot<Number_t>(h.normal, offset_vector);
+        output_fn(h);
+      }
     }
   }
 }
@@ -0,0 +1,105 @@
+#ifndef FILTERED_PREDICATES_HPP_
+#define FILTERED_PREDICATES_HPP_
+
+#include "linalg.hpp"
+
+#include <cfloat>
+#include <cmath>
+#include <gmpxx.h>
+
+namespace zonotope {
+
+/**
+ * @brief The sign of `a*b - c*e`, evaluated exactly
+ */
+template <typename NT>
+inline int _sign_of_mul_sub_exact(const NT& a, const NT& b, const NT& c, const NT& e) {
+  const NT lhs = a * b;
+  const NT rhs = c * e;
+  return ( lhs > rhs ) - ( lhs < rhs );
+}
+
+template <>
+inline int _sign_of_mul_sub_exact<mpz_class>( const mpz_class& a,
+                                              const mpz_class& b,
+                                              const mpz_class& c,
+                                              const mpz_class& e )
+{
+  mpz_class lhs;
+  mpz_mul(lhs.get_mpz_t(), a.get_mpz_t(), b.get_mpz_t());
+  mpz_submul(lhs.get_mpz_t(), c.get_mpz_t(), e.get_mpz_t());
+  return sgn(lhs);
+}
+
+#ifdef __SIZEOF_INT128__
+template <>
+inline int _sign_of_mul_sub_exact<long>(const long& a, const long& b, const long& c, const long& e) {
+  const __int128 lhs = __int128(a) * b;
+  const __int128 rhs = __int128(c) * e;
+  return ( lhs > rhs ) - ( lhs < rhs );
+}
+#endif // __SIZEOF_INT128__
+
+/**
+ * @brief A floating-point filter for the sign of `a*b - c*e`.
+ *
+ * The arguments are the double approximations of exact numbers, each
+ * with a relative error below DBL_EPSILON (which holds for
+ * _to_double). Each product then has a relative error below
+ * 3.01*DBL_EPSILON, so the computed difference has the same sign as
+ * the exact one whenever it exceeds 4*DBL_EPSILON * (|a*b| + |c*e|).
+ * The filter uses twice that bound for the rounding of the bound
+ * itself.
+ *
+ * @return The sign of `a*b - c*e` if it is certain, or 2 if the filter
+ *         fails and the sign has to be evaluated exactly.
+ */
+inline int _sign_of_mul_sub_filter(const double a, const double b, const double c, const double e) {
+  const double lhs = a * b;
+  const double rhs = c * e;
+  const double difference = lhs - rhs;
+  const double bound = 8 * DBL_EPSILON * ( std::fabs(lhs) + std::fabs(rhs) );
+  if ( std::fabs(difference) > bound ) {
+    return ( difference > 0 ) ? 1 : -1;
+  }
+  if ( ( a == 0 || b == 0 ) && ( c == 0 || e == 0 ) ) {
+    // both products are exactly 0, since a double approximation is
+    // only 0 for 0 itself
+    return 0;
+  }
+  return 2;
+}
+
+/**
+ * @brief The sign of `a*b - c*e`, as a filtered predicate.
+ *
+ * Like the filtered predicates of CGAL, it first tries to determine
+ * the sign from double approximations with a certified error bound
+ * (see _sign_of_mul_sub_filter), and only evaluates the products
+ * exactly when the filter fails, which only happens when a*b and c*e
+ * are very close. Machine integer types skip the filter, since their
+ * exact evaluation is already cheap.
+ */
+template <typename NT>
+inline int sign_of_mul_sub(const NT& a, const NT& b, const NT& c, const NT& e) {
+  const int sign = _sign_of_mul_sub_filter( _to_double(a), _to_double(b),
+                                            _to_double(c), _to_double(e) );
+  if ( sign != 2 ) {
+    return sign;
+  }
+  return _sign_of_mul_sub_exact<NT>(a, b, c, e);
+}
+
+template <>
+inline int sign_of_mul_sub<long>(const long& a, const long& b, const long& c, const long& e) {
+  return _sign_of_mul_sub_exact<long>(a, b, c, e);
+}
+
+template <>
+inline int sign_of_mul_sub<double>(const double& a, const double& b, const double& c, const double& e) {
+  return _sign_of_mul_sub_exact<double>(a, b, c, e);
+}
+
+} // namespace zonotope
+
+#endif // FILTERED_PREDICATES_HPP_
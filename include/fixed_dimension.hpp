@@ -0,0 +1,77 @@
+#ifndef FIXED_DIMENSION_HPP_
+#define FIXED_DIMENSION_HPP_
+
+#include <array>
+#include <vector>
+
+/**
+ * The largest dimension for which zonotope_volume and
+ * zonotope_halfspaces instantiate their containers with a compile-time
+ * dimension (see dispatch_dimension). Define it as 0 to use only the
+ * runtime dimension, e.g. to reduce compile times.
+ */
+#ifndef LIBZONOTOPE_MAX_FIXED_DIMENSION
+#define LIBZONOTOPE_MAX_FIXED_DIMENSION 8
+#endif
+
+namespace zonotope {
+
+/**
+ * @brief A vector of D numbers, or of a runtime length if D = 0
+ *
+ * The combination containers take a compile-time dimension D, where
+ * D = 0 (the default) means that the dimension is only known at
+ * runtime. For D > 0, the scratch vectors are std::arrays.
+ */
+template <typename NT, int D>
+struct Fixed_vector {
+  typedef std::array<NT, D> type;
+
+  static void resize( type&, const int ) {}
+};
+
+template <typename NT>
+struct Fixed_vector<NT, 0> {
+  typedef std::vector<NT> type;
+
+  static void resize( type& v, const int d ) {
+    v.resize(d);
+  }
+};
+
+template <int D,
+          typename Functor,
+          bool Is_past_max = ( D > LIBZONOTOPE_MAX_FIXED_DIMENSION )>
+struct _Dimension_dispatch {
+  static typename Functor::result_type run( const int d, Functor& f ) {
+    if ( d == D ) {
+      return f.template run<D>();
+    }
+    return _Dimension_dispatch<D+1, Functor>::run(d, f);
+  }
+};
+
+template <int D, typename Functor>
+struct _Dimension_dispatch<D, Functor, true> {
+  static typename Functor::result_type run( const int, Functor& f ) {
+    return f.template run<0>();
+  }
+};
+
+/**
+ * @brief Call `f.template run<D>()` with D = d if 2 <= d <=
+ *        LIBZONOTOPE_MAX_FIXED_DIMENSION, and with D = 0 otherwise.
+ *
+ * With the dimension known at compile time, the loops over the
+ * coordinates in linalg.hpp have constant trip counts, so the compiler
+ * can unroll them. Functor must define `result_type`.
+ */
+template <typename Functor>
+typename Functor::result_type dispatch_dimension( const int d, Functor& f )
+{
+  return _Dimension_dispatch<2, Functor>::run(d, f);
+}
+
+} // namespace zonotope
+
+#endif // FIXED_DIMENSION_HPP_
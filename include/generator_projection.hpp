@@ -0,0 +1,229 @@
+#ifndef GENERATOR_PROJECTION_HPP_
+#define GENERATOR_PROJECTION_HPP_
+
+#include "linalg.hpp"
+#include "matrix.hpp"
+
+#include <vector>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace zonotope {
+
+/**
+ * @brief Projects all generators onto a pair of vectors (c0, c1) in one pass.
+ *
+ * This is the first step of handle_event_points, which needs
+ *
+ *     x[i] = dot(c0, generators[i]),  y[i] = dot(c1, generators[i])
+ *
+ * for all n generators, and for every (d-2)-combination. The generic
+ * version evaluates the dot products exactly, with _add_mul so that no
+ * temporaries are allocated for mpz_class. The specializations for
+ * long and double (and Checked_integer, see checked_integer.hpp) keep
+ * a transposed copy of the generators, so that the projection becomes
+ * 2*d passes of `x += c * row` over contiguous rows of length n, which
+ * are vectorized with AVX-512 or AVX2 when available.
+ */
+template <typename Number_t>
+struct Generator_projection;
+
+/**
+ * @brief The exact projection, for any number type
+ */
+template <typename Number_t>
+struct Exact_generator_projection {
+
+  const Matrix<Number_t>& generators;
+
+  Exact_generator_projection( const Matrix<Number_t>& generators )
+    : generators(generators)
+    { }
+
+  int size() const {
+    return generators.rows();
+  }
+
+  template <typename Vector_t>
+  void operator() ( const Vector_t& c0,
+                    const Vector_t& c1,
+                    std::vector<Number_t>& x,
+                    std::vector<Number_t>& y ) const
+  {
+    const int n = generators.rows();
+    const int d = generators.cols();
+    for ( int i = 0; i < n; ++i ) {
+      const auto& v = generators[i];
+      x[i] = 0;
+      y[i] = 0;
+      for ( int r = 0; r < d; ++r ) {
+        _add_mul<Number_t>(x[i], c0[r], v[r]);
+        _add_mul<Number_t>(y[i], c1[r], v[r]);
+      }
+    }
+  }
+};
+
+template <typename Number_t>
+struct Generator_projection : Exact_generator_projection<Number_t> {
+
+  Generator_projection( const Matrix<Number_t>& generators )
+    : Exact_generator_projection<Number_t>(generators)
+    { }
+};
+
+/**
+ * @brief Set `x[i] += a * row[i]` and `y[i] += b * row[i]` for i < n
+ */
+inline void _project_row( const double a,
+                          const double b,
+                          const double* row,
+                          double* x,
+                          double* y,
+                          const int n )
+{
+  int i = 0;
+#if defined(__AVX512F__)
+  const __m512d va = _mm512_set1_pd(a);
+  const __m512d vb = _mm512_set1_pd(b);
+  for ( ; i + 8 <= n; i += 8 ) {
+    const __m512d v = _mm512_load_pd(row + i);
+    _mm512_storeu_pd(x + i, _mm512_fmadd_pd(va, v, _mm512_loadu_pd(x + i)));
+    _mm512_storeu_pd(y + i, _mm512_fmadd_pd(vb, v, _mm512_loadu_pd(y + i)));
+  }
+#elif defined(__AVX2__)
+  const __m256d va = _mm256_set1_pd(a);
+  const __m256d vb = _mm256_set1_pd(b);
+  for ( ; i + 4 <= n; i += 4 ) {
+    const __m256d v = _mm256_load_pd(row + i);
+#if defined(__FMA__)
+    _mm256_storeu_pd(x + i, _mm256_fmadd_pd(va, v, _mm256_loadu_pd(x + i)));
+    _mm256_storeu_pd(y + i, _mm256_fmadd_pd(vb, v, _mm256_loadu_pd(y + i)));
+#else
+    _mm256_storeu_pd(x + i, _mm256_add_pd(_mm256_mul_pd(va, v), _mm256_loadu_pd(x + i)));
+    _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_mul_pd(vb, v), _mm256_loadu_pd(y + i)));
+#endif
+  }
+#endif
+  for ( ; i < n; ++i ) {
+    x[i] += a * row[i];
+    y[i] += b * row[i];
+  }
+}
+
+inline void _project_row( const long a,
+                          const long b,
+                          const long* row,
+                          long* x,
+                          long* y,
+                          const int n )
+{
+  int i = 0;
+#if defined(__AVX512DQ__)
+  // AVX2 has no 64-bit multiplication, so only AVX-512DQ is used here
+  const __m512i va = _mm512_set1_epi64(a);
+  const __m512i vb = _mm512_set1_epi64(b);
+  for ( ; i + 8 <= n; i += 8 ) {
+    const __m512i v = _mm512_load_si512(row + i);
+    const __m512i vx = _mm512_loadu_si512(x + i);
+    const __m512i vy = _mm512_loadu_si512(y + i);
+    _mm512_storeu_si512(x + i, _mm512_add_epi64(vx, _mm512_mullo_epi64(va, v)));
+    _mm512_storeu_si512(y + i, _mm512_add_epi64(vy, _mm512_mullo_epi64(vb, v)));
+  }
+#endif
+  for ( ; i < n; ++i ) {
+    x[i] += a * row[i];
+    y[i] += b * row[i];
+  }
+}
+
+/**
+ * @brief The projection for the machine number types
+ *
+ * The transposed generators are stored with 64-byte aligned rows, so
+ * that the vector loads of a row are aligned.
+ */
+template <typename Machine_number_t>
+struct Machine_generator_projection {
+
+  /**
+   * d-by-n, transposed[r][i] = generators[i][r]
+   */
+  Matrix<Machine_number_t, 64> transposed;
+
+  Machine_generator_projection() {}
+
+  template <typename Generator_container_t>
+  Machine_generator_projection( const Generator_container_t& generators )
+    : transposed(generators.cols(), generators.rows())
+  {
+    for ( int i = 0; i < generators.rows(); ++i ) {
+      for ( int r = 0; r < generators.cols(); ++r ) {
+        transposed[r][i] = generators[i][r];
+      }
+    }
+  }
+
+  int size() const {
+    return transposed.cols();
+  }
+
+  /**
+   * @brief The projection onto (c0, c1), given as arrays of d numbers
+   */
+  void project( const Machine_number_t* c0,
+                const Machine_number_t* c1,
+                Machine_number_t* x,
+                Machine_number_t* y ) const
+  {
+    const int n = transposed.cols();
+    const int d = transposed.rows();
+    for ( int i = 0; i < n; ++i ) {
+      x[i] = 0;
+      y[i] = 0;
+    }
+    for ( int r = 0; r < d; ++r ) {
+      _project_row(c0[r], c1[r], transposed[r].data(), x, y, n);
+    }
+  }
+};
+
+template <>
+struct Generator_projection<double> : Machine_generator_projection<double> {
+
+  Generator_projection( const Matrix<double>& generators )
+    : Machine_generator_projection<double>(generators)
+    { }
+
+  template <typename Vector_t>
+  void operator() ( const Vector_t& c0,
+                    const Vector_t& c1,
+                    std::vector<double>& x,
+                    std::vector<double>& y ) const
+  {
+    project(&c0[0], &c1[0], x.data(), y.data());
+  }
+};
+
+template <>
+struct Generator_projection<long> : Machine_generator_projection<long> {
+
+  Generator_projection( const Matrix<long>& generators )
+    : Machine_generator_projection<long>(generators)
+    { }
+
+  template <typename Vector_t>
+  void operator() ( const Vector_t& c0,
+                    const Vector_t& c1,
+                    std::vector<long>& x,
+                    std::vector<long>& y ) const
+  {
+    project(&c0[0], &c1[0], x.data(), y.data());
+  }
+};
+
+} // namespace zonotope
+
+#endif // GENERATOR_PROJECTION_HPP_
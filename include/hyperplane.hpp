@@ -98,46 +98,26 @@ struct Hyperplane {
 
 
 /**
- * Specialize Type_casting_functor for integral
+ * Specialize Type_casting_functor for hyperplanes, by casting the
+ * offset and the normal coordinate-wise.
  */
-template <>
-struct Type_casting_functor<Hyperplane<mpz_class>, Hyperplane<long> > {
-  Type_casting_functor<mpz_class, long> Cast_mpz_to_long;
+template <typename Input_number_t, typename Output_number_t>
+struct Type_casting_functor<Hyperplane<Input_number_t>, Hyperplane<Output_number_t> > {
+  Type_casting_functor<Input_number_t, Output_number_t> Cast_number;
 
-  Hyperplane<long> operator() (const Hyperplane<mpz_class>& h_mpz ) const {
-    const int d = h_mpz.normal.size();
+  Hyperplane<Output_number_t> operator() (const Hyperplane<Input_number_t>& h_in ) const {
+    const int d = h_in.normal.size();
 
-    Hyperplane<long> h_long (d);
+    Hyperplane<Output_number_t> h_out (d);
 
-    h_long.offset = Cast_mpz_to_long(h_mpz.offset);
+    h_out.offset = Cast_number(h_in.offset);
     for ( int i = 0; i < d; ++i ) {
-      h_long.normal[i] = Cast_mpz_to_long(h_mpz.normal[i]);
+      h_out.normal[i] = Cast_number(h_in.normal[i]);
     }
-    return h_long;
+    return h_out;
   }
 };
 
-/**
- * Specialize Type_casting_functor for double
- */
-template <>
-struct Type_casting_functor<Hyperplane<mpz_class>, Hyperplane<double> > {
-  Type_casting_functor<mpz_class, double> Cast_mpz_to_double;
-
-  Hyperplane<double> operator() (const Hyperplane<mpz_class>& h_mpz ) const {
-    const int d = h_mpz.normal.size();
-
-    Hyperplane<double> h_double (d);
-
-    h_double.offset = Cast_mpz_to_double(h_mpz.offset);
-    for ( int i = 0; i < d; ++i ) {
-      h_double.normal[i] = Cast_mpz_to_double(h_mpz.normal[i]);
-    }
-    return h_double;
-  }
-};
-
-
 } // namespace zonotope
 
 #endif // HYPERPLANE_HPP_
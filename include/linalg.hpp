@@ -2,6 +2,7 @@
 #define LINALG_HPP_
 
 #include "standardize_vector.hpp"
+#include "matrix.hpp"
 
 #include <vector>
 #include <utility>
@@ -9,14 +10,109 @@
 
 #include <iostream>
 #include <utility>
+#include <gmpxx.h>
 
 namespace zonotope {
 
+/**
+ * @brief x to the power n
+ */
+template <typename T>
+inline T _pow(const T& x, unsigned int n) {
+  T y = 1;
+  for ( unsigned int i = 0; i < n; ++i ) {
+    y *= x;
+  }
+  return y;
+}
+
+template <>
+inline mpz_class _pow<mpz_class>(const mpz_class& x, unsigned int n) {
+  mpz_class y;
+  mpz_pow_ui(y.get_mpz_t(), x.get_mpz_t(), n);
+  return y;
+}
+
+/**
+ * @brief An approximation of a as a double
+ */
+template <typename NT>
+inline double _to_double(const NT& a) {
+  return double(a);
+}
+
+template <>
+inline double _to_double<mpz_class>(const mpz_class& a) {
+  return a.get_d();
+}
+
+/**
+ * @brief Set `a = a + b*c`
+ */
+template <typename NT>
+inline void _add_mul(NT& a, const NT& b, const NT& c) {
+  a += b * c;
+}
+
+template <>
+inline void _add_mul<mpz_class>(mpz_class& a, const mpz_class& b, const mpz_class& c) {
+  mpz_addmul(a.get_mpz_t(), b.get_mpz_t(), c.get_mpz_t());
+}
+
+/**
+ * @brief Set `a = a*b - c*e`
+ *
+ * This is the elementary step of the fraction-free updates below. It
+ * can be specialized for number types that can evaluate it faster
+ * than with two separate products (see checked_integer.hpp).
+ */
+template <typename NT>
+inline void _mul_sub(NT& a, const NT& b, const NT& c, const NT& e) {
+  a *= b;
+  a -= c * e;
+}
+
+/**
+ * @brief Set `a = (a*b - c*e) / f`, where the division is known to be
+ *        exact.
+ */
+template <typename NT>
+inline void _mul_sub_div(NT& a, const NT& b, const NT& c, const NT& e, const NT& f) {
+  a *= b;
+  a -= c * e;
+  a /= f;
+}
+
+template <>
+inline void _mul_sub<mpz_class>( mpz_class& a,
+                                 const mpz_class& b,
+                                 const mpz_class& c,
+                                 const mpz_class& e )
+{
+  mpz_mul(a.get_mpz_t(), a.get_mpz_t(), b.get_mpz_t());
+  mpz_submul(a.get_mpz_t(), c.get_mpz_t(), e.get_mpz_t());
+}
+
+template <>
+inline void _mul_sub_div<mpz_class>( mpz_class& a,
+                                     const mpz_class& b,
+                                     const mpz_class& c,
+                                     const mpz_class& e,
+                                     const mpz_class& f )
+{
+  mpz_mul(a.get_mpz_t(), a.get_mpz_t(), b.get_mpz_t());
+  mpz_submul(a.get_mpz_t(), c.get_mpz_t(), e.get_mpz_t());
+  mpz_divexact(a.get_mpz_t(), a.get_mpz_t(), f.get_mpz_t());
+}
+
 /**
  * @brief The dot product of two vectors.
+ *
+ * The vectors may be of different types, e.g. a std::vector and a row
+ * of a Matrix.
  */
-template <typename NT, typename Vector_t = std::vector<NT> >
-inline NT dot( const Vector_t& a, const Vector_t& b )
+template <typename NT, typename Vector_a_t = std::vector<NT>, typename Vector_b_t = Vector_a_t>
+inline NT dot( const Vector_a_t& a, const Vector_b_t& b )
 {
   const int d = a.size();
   NT result = 0;
@@ -26,14 +122,44 @@ inline NT dot( const Vector_t& a, const Vector_t& b )
   return result;
 }
 
+/**
+ * @brief The length of v, which is D if D > 0
+ *
+ * The functions below take an optional compile-time dimension D (see
+ * fixed_dimension.hpp), so that their loops over the coordinates have
+ * constant trip counts when it is given.
+ */
+template <int D, typename Vector_t>
+inline int _dimension( const Vector_t& v )
+{
+  return ( D > 0 ) ? D : int(v.size());
+}
+
+/**
+ * @brief true iff dot(a, b) == 0
+ *
+ * Accumulates the dot product in `product` with _add_mul, so that it
+ * allocates no temporaries once `product` has grown.
+ */
+template <typename NT, int D = 0, typename Vector_a_t, typename Vector_b_t>
+inline bool _is_orthogonal( const Vector_a_t& a, const Vector_b_t& b, NT& product )
+{
+  const int d = _dimension<D>(a);
+  product = 0;
+  for ( int i = 0; i < d; ++i ) {
+    _add_mul<NT>(product, a[i], b[i]);
+  }
+  return ( product == 0 );
+}
+
 template<typename NT>
-inline std::vector<std::vector<NT> >
+inline Matrix<NT>
 zero_matrix(const int d) {
-  return std::vector<std::vector<NT> > (d, std::vector<NT>(d, NT(0)));
+  return Matrix<NT> (d, d, NT(0));
 }
 
 template<typename NT>
-inline std::vector<std::vector<NT> >
+inline Matrix<NT>
 identity_matrix(const int d) {
   auto result = zero_matrix<NT> (d);
   for ( int i = 0; i < d; ++i ) {
@@ -46,26 +172,28 @@ identity_matrix(const int d) {
 /**
  * @brief Update a kernel basis when a vector is added to a combination
  *
- * @param kernel the basis of the kernel to be restricted
-
+ * @param kernel the basis of the kernel to be restricted, stored in
+ *        its first k rows (either a Matrix or a vector of vectors)
+ *
+ * @param k the size of the kernel basis
+ *
  * @param v the vector to be added to the combination (used to
  *        restrict the kernel).
  *
- * @post kernel has been updated to account for the new vector. If v
- *       is already in the span of the combination, then kernel
- *       remains untouched.
+ * @post kernel and k have been updated to account for the new
+ *       vector. If v is already in the span of the combination, then
+ *       kernel remains untouched.
  */
 
-template <typename NT, typename Vector_t = std::vector<NT> >
-void update_kernel( std::vector<Vector_t>& kernel, const Vector_t& v )
+template <typename NT, typename Matrix_t, typename Vector_t>
+void update_kernel( Matrix_t& kernel, int& k, const Vector_t& v )
 {
-  const int d = kernel[0].size();
-  const int k = kernel.size();
+  const int d = v.size();
 
-  Vector_t x = v;
+  std::vector<NT> x (k);
   int j = -1;
   for ( int i = 0; i < k; ++i ) {
-    x[i] = dot<NT, Vector_t> ( kernel[i], v );
+    x[i] = dot<NT> ( kernel[i], v );
     if ( x[i] != 0 ) {
       j = i;
     }
@@ -76,16 +204,17 @@ void update_kernel( std::vector<Vector_t>& kernel, const Vector_t& v )
     return;
   }
 
-  std::swap(kernel[k-1], kernel[j]);
+  swap_rows(kernel, k-1, j);
   std::swap(x[k-1], x[j]);
 
   for ( int i = 0; i < k - 1; ++i ) {
+    auto&& row = kernel[i];
     for ( int r = 0; r < d; ++r ) {
-      kernel[i][r] = x[k-1]*kernel[i][r] - x[i]*kernel[k-1][r];
+      _mul_sub<NT>(row[r], x[k-1], x[i], kernel[k-1][r]);
     }
-    standardize_vector<NT, Vector_t> ( kernel[i] );
+    standardize_vector<NT> ( row );
   }
-  kernel.pop_back();
+  --k;
 }
 
 /**
@@ -107,20 +236,20 @@ void update_kernel( std::vector<Vector_t>& kernel, const Vector_t& v )
  *       [combination, next_element].
  *
  */
-template <typename NT, typename Vector_t = std::vector<NT> >
-void update_inverse( const std::vector<Vector_t>& generators,
+template <typename NT, typename Generator_container_t, typename Matrix_t>
+void update_inverse( const Generator_container_t& generators,
                      const std::vector<int>& combination,
                      const int next_element,
-                     std::vector<Vector_t>& inverse,
+                     Matrix_t& inverse,
                      NT& determinant) {
 
   const int k = combination.size();
   const int d = generators[0].size();
 
-  const Vector_t& x = generators[next_element];
+  const auto& x = generators[next_element];
 
   // init lambda
-  Vector_t lambda (d);
+  std::vector<NT> lambda (d);
   for ( int i = 0; i < d; ++i ) {
     lambda[i] = 0;
     for ( int j = 0; j < d; ++j ) {
@@ -145,16 +274,14 @@ void update_inverse( const std::vector<Vector_t>& generators,
 
   if ( k != pivot_row ) {
     std::swap( lambda[pivot_row], lambda[k] );
-    std::swap( inverse[pivot_row], inverse[k] );
+    swap_rows( inverse, pivot_row, k );
   }
 
   // update the inverse
   for ( int i = 0; i < d; ++i ) {
     for ( int j = 0; j < d; ++j ) {
       if ( i != k ) {
-        inverse[i][j] *= lambda[k];
-        inverse[i][j] -= lambda[i] * inverse[k][j];
-        inverse[i][j] /= determinant;
+        _mul_sub_div<NT>(inverse[i][j], lambda[k], lambda[i], inverse[k][j], determinant);
       }
     }
   }
@@ -167,6 +294,167 @@ void update_inverse( const std::vector<Vector_t>& generators,
   }
 }
 
+/**
+ * @brief A variant of update_kernel that writes the restricted kernel
+ *        to a separate matrix.
+ *
+ * It performs no heap allocations for number types that reuse their
+ * storage on assignment (like mpz_class, once the storage has grown
+ * large enough), which makes it suitable for containers that keep
+ * one preallocated matrix per combination size.
+ *
+ * @param kernel The first m rows are a basis of the current kernel
+ *
+ * @param v the vector to be added to the combination
+ *
+ * @param kernel_out On success, the first (m-1) rows are a basis of
+ *                   the restricted kernel.
+ *
+ * @param x A scratch vector with room for m numbers
+ *
+ * @param gcd A scratch number
+ *
+ * @return false iff v is already in the span of the combination, in
+ *         which case kernel_out is untouched.
+ */
+template <typename NT,
+          int D = 0,
+          typename Matrix_in_t,
+          typename Matrix_out_t,
+          typename Vector_t,
+          typename Scratch_t>
+bool update_kernel_into( const Matrix_in_t& kernel,
+                         const int m,
+                         const Vector_t& v,
+                         Matrix_out_t&& kernel_out,
+                         Scratch_t& x,
+                         NT& gcd )
+{
+  const int d = _dimension<D>(v);
+
+  int j = -1;
+  for ( int i = 0; i < m; ++i ) {
+    x[i] = 0;
+    for ( int r = 0; r < d; ++r ) {
+      _add_mul<NT>(x[i], kernel[i][r], v[r]);
+    }
+    if ( x[i] != 0 ) {
+      j = i;
+    }
+  }
+
+  if ( j == -1 ) {
+    // v is already in the combination
+    return false;
+  }
+
+  // same as update_kernel, where row j takes the place of row (m-1)
+  for ( int i = 0; i < m - 1; ++i ) {
+    const int source_row = ( i == j ) ? ( m - 1 ) : i;
+    auto&& row = kernel_out[i];
+    for ( int r = 0; r < d; ++r ) {
+      row[r] = kernel[source_row][r];
+      _mul_sub<NT>(row[r], x[j], x[source_row], kernel[j][r]);
+    }
+    standardize_vector<NT> ( row, gcd );
+  }
+  return true;
+}
+
+/**
+ * @brief A variant of update_inverse that writes the updated inverse
+ *        to a separate matrix.
+ *
+ * Like update_kernel_into, it performs no heap allocations for number
+ * types that reuse their storage on assignment.
+ *
+ * @param x the vector to be appended to the combination
+ *
+ * @param k the size of the combination before x is appended
+ *
+ * @param inverse The accumulated row operations for the current
+ *                combination (see update_inverse)
+ *
+ * @param determinant `1 / det(inverse)`
+ *
+ * @param inverse_out On success, the accumulated row operations for
+ *                    the extended combination.
+ *
+ * @param determinant_out On success, `1 / det(inverse_out)`
+ *
+ * @param lambda A scratch vector with room for d numbers
+ *
+ * @return false iff appending x makes the vector combination singular,
+ *         in which case inverse_out and determinant_out are untouched.
+ */
+template <typename NT,
+          int D = 0,
+          typename Matrix_in_t,
+          typename Matrix_out_t,
+          typename Vector_t,
+          typename Scratch_t>
+bool update_inverse_into( const Vector_t& x,
+                          const int k,
+                          const Matrix_in_t& inverse,
+                          const NT& determinant,
+                          Matrix_out_t&& inverse_out,
+                          NT& determinant_out,
+                          Scratch_t& lambda )
+{
+  const int d = _dimension<D>(x);
+
+  // the candidate pivot rows come first, so that we can return early
+  // when x makes the combination singular
+  int pivot_row = -1;
+  for ( int i = k; i < d; ++i ) {
+    lambda[i] = 0;
+    for ( int j = 0; j < d; ++j ) {
+      _add_mul<NT>(lambda[i], inverse[i][j], x[j]);
+    }
+    if ( pivot_row == -1 && lambda[i] != 0 ) {
+      pivot_row = i;
+    }
+  }
+
+  if ( pivot_row == -1 ) {
+    // adding x makes the vector combination singular
+    return false;
+  }
+
+  for ( int i = 0; i < k; ++i ) {
+    lambda[i] = 0;
+    for ( int j = 0; j < d; ++j ) {
+      _add_mul<NT>(lambda[i], inverse[i][j], x[j]);
+    }
+  }
+
+  // same as update_inverse, where the rows k and pivot_row trade places
+  for ( int i = 0; i < d; ++i ) {
+    int source_row = i;
+    if ( i == k ) {
+      source_row = pivot_row;
+    } else if ( i == pivot_row ) {
+      source_row = k;
+    }
+    auto&& row = inverse_out[i];
+    const auto& source = inverse[source_row];
+    const auto& pivot = inverse[pivot_row];
+    for ( int j = 0; j < d; ++j ) {
+      row[j] = source[j];
+      if ( i != k ) {
+        _mul_sub_div<NT>(row[j], lambda[pivot_row], lambda[source_row],
+                         pivot[j], determinant);
+      }
+    }
+  }
+
+  determinant_out = lambda[pivot_row];
+  if ( k != pivot_row ) {
+    determinant_out *= -1;
+  }
+  return true;
+}
+
 } // namespace zonotope
 
 #endif // LINALG_HPP_
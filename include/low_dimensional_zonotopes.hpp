@@ -0,0 +1,239 @@
+#ifndef LOW_DIMENSIONAL_ZONOTOPES_HPP_
+#define LOW_DIMENSIONAL_ZONOTOPES_HPP_
+
+#include "event_point_2.hpp"
+#include "angular_sort.hpp"
+#include "combination_kernel_stack.hpp"
+#include "preprocess_generators.hpp"
+#include "matrix.hpp"
+
+// External dependencies
+#include <vector>
+#include <unordered_set>
+#include <gmpxx.h>
+
+namespace zonotope {
+
+/**
+ * @brief Pass every halfspace of a zonogon (in terms of the internal
+ *        generators) to output_fn.
+ *
+ * In two dimensions, the only (d-2)-combination is the empty one, and
+ * its kernel is the whole plane. So this is a single call to
+ * handle_event_points with the standard basis, i.e. one angular sort
+ * of the generators, without the combination traversal or a kernel
+ * container. The generators need not be merged first: the parallel
+ * ones have the same angle, and only the first of them produces a
+ * facet.
+ */
+template <typename Number_t,
+          typename Halfspaces_output_functor_t>
+void zonogon_halfspaces_traversal (
+  const Matrix<Number_t>& generators,
+  Halfspaces_output_functor_t& output_fn )
+{
+  std::vector<Number_t> c0 (2, Number_t(0));
+  std::vector<Number_t> c1 (2, Number_t(0));
+  c0[0] = 1;
+  c1[1] = 1;
+
+  Event_point_buffer<Number_t> buffer (generators);
+
+  // only the zero generators project to the origin, and they are
+  // spanned by the empty combination
+  const auto spanned_by_smaller = [](int) { return true; };
+
+  handle_event_points( -1, c0, c1, generators, spanned_by_smaller, buffer, output_fn );
+}
+
+/**
+ * @brief The vertices of a zonogon, in counterclockwise order
+ *
+ * Takes the segments of merge_parallel_generators. Each segment is
+ * oriented into the upper half-plane, and the edges of the zonogon are
+ * the oriented segments sorted by angle, followed by their negations.
+ * The walk starts at the sum of the tails of the oriented segments
+ * (the lowest vertex), so this takes O(n*log(n)) for n segments.
+ */
+template <typename Number_t, typename Segment_t>
+std::vector<std::vector<Number_t> >
+zonogon_vertices (const std::vector<Segment_t>& segments)
+{
+  const int n = segments.size();
+
+  std::vector<Number_t> x (n);
+  std::vector<Number_t> y (n);
+  std::vector<int> events (n);
+  std::vector<Number_t> vertex (2, Number_t(0));
+
+  for ( int i = 0; i < n; ++i ) {
+    const auto& head = segments[i].first;
+    const auto& tail = segments[i].second;
+    x[i] = head[0] - tail[0];
+    y[i] = head[1] - tail[1];
+    if ( y[i] < 0 || ( y[i] == 0 && x[i] < 0 ) ) {
+      x[i] = -x[i];
+      y[i] = -y[i];
+      vertex[0] += head[0];
+      vertex[1] += head[1];
+    } else {
+      vertex[0] += tail[0];
+      vertex[1] += tail[1];
+    }
+    events[i] = 2*i;
+  }
+
+  Angular_sort<Number_t> angular_sort;
+  angular_sort( x, y, events );
+
+  std::vector<std::vector<Number_t> > vertices;
+  vertices.reserve( ( n > 0 ) ? 2*n : 1 );
+  vertices.push_back(vertex);
+
+  // the last edge leads back to the first vertex
+  for ( int half = 0; half < 2; ++half ) {
+    for ( int position = 0; position < n; ++position ) {
+      if ( half == 1 && position == n-1 ) {
+        break;
+      }
+      const int i = events[position] >> 1;
+      if ( half == 0 ) {
+        vertex[0] += x[i];
+        vertex[1] += y[i];
+      } else {
+        vertex[0] -= x[i];
+        vertex[1] -= y[i];
+      }
+      vertices.push_back(vertex);
+    }
+  }
+  return vertices;
+}
+
+/**
+ * @brief The vertices of a three-dimensional zonotope
+ *
+ * Takes the segments of merge_parallel_generators, whose coordinates
+ * must be integral (see Is_integral_number). Every vertex is an
+ * endpoint of an edge, and the edges parallel to the segment i are
+ * the regions of the great circle orthogonal to it, cut by the other
+ * segments. So, for every segment, the other segments are projected
+ * onto its kernel and sorted by angle (as in handle_event_points), and
+ * a halfplane is rotated around the origin while the vertex that
+ * minimizes its normal is updated. Both endpoints of the edge of every
+ * region are collected, and the duplicates (a vertex is found once for
+ * every incident edge) are removed by hashing.
+ *
+ * This takes O(n^2*log(n)) for n segments, with no adjacency oracle.
+ * The vertices are in no particular order.
+ */
+template <typename Number_t, typename Segment_t>
+std::vector<std::vector<Number_t> >
+spatial_zonotope_vertices (const std::vector<Segment_t>& segments)
+{
+  typedef std::vector<Number_t> Vector_t;
+
+  const int n = segments.size();
+  const int d = 3;
+
+  // The vertex of the sign vector s is base plus the directions of the
+  // segments i with s[i] = true
+  std::vector<Vector_t> directions (n, Vector_t(d));
+  Vector_t base (d, Number_t(0));
+  for ( int i = 0; i < n; ++i ) {
+    for ( int r = 0; r < d; ++r ) {
+      directions[i][r] = segments[i].first[r] - segments[i].second[r];
+      base[r] += segments[i].second[r];
+    }
+  }
+
+  std::vector<Vector_t> vertices;
+  if ( n == 0 ) {
+    vertices.push_back(base);
+    return vertices;
+  }
+
+  // the angles are compared exactly
+  Matrix<mpz_class> internal_directions;
+  preprocess_generators<Number_t, mpz_class> (directions, internal_directions);
+
+  Combination_kernel_stack<mpz_class, 3> combination (internal_directions, 1);
+  Event_point_buffer<mpz_class> buffer (internal_directions);
+  std::vector<mpz_class>& x = buffer.x;
+  std::vector<mpz_class>& y = buffer.y;
+  std::vector<int>& events = buffer.events;
+
+  std::unordered_set<Vector_t, _Vector_hash<Number_t> > found_vertices;
+  found_vertices.reserve(2*n*n);
+  Vector_t vertex (d);
+  Vector_t other_endpoint (d);
+
+  const auto add_edge = [&](const int i) {
+    for ( int r = 0; r < d; ++r ) {
+      other_endpoint[r] = vertex[r] + directions[i][r];
+    }
+    if ( found_vertices.insert(vertex).second ) {
+      vertices.push_back(vertex);
+    }
+    if ( found_vertices.insert(other_endpoint).second ) {
+      vertices.push_back(other_endpoint);
+    }
+  };
+
+  for ( int i = 0; i < n; ++i ) {
+    combination.extend(i);
+    buffer.projection( combination.kernel_row(0), combination.kernel_row(1), x, y );
+
+    // The initial halfplane is everything below the x-axis, and the
+    // segments in it are at their first endpoints. Only i projects to
+    // the origin, since the segments are not parallel.
+    events.clear();
+    vertex = base;
+    for ( int j = 0; j < n; ++j ) {
+      if ( y[j] < 0 || ( y[j] == 0 && x[j] < 0 ) ) {
+        events.push_back( 2*j + 1 );
+        for ( int r = 0; r < d; ++r ) {
+          vertex[r] += directions[j][r];
+        }
+      } else if ( x[j] != 0 || y[j] != 0 ) {
+        events.push_back( 2*j );
+      }
+    }
+    buffer.angular_sort( x, y, events );
+
+    const int num_events = events.size();
+    if ( num_events == 0 ) {
+      // the zonotope is the segment i
+      add_edge(i);
+    }
+
+    // The halfplane defines a region after the last event of every
+    // angle, in both halves
+    for ( int half = 0; half < 2; ++half ) {
+      for ( int position = 0; position < num_events; ++position ) {
+        const int upper_event = events[position];
+        const int event = ( half == 0 ) ? upper_event : ( upper_event ^ 1 );
+        const int j = event >> 1;
+        const bool negated = ( event & 1 );
+
+        for ( int r = 0; r < d; ++r ) {
+          if ( negated ) {
+            vertex[r] -= directions[j][r];
+          } else {
+            vertex[r] += directions[j][r];
+          }
+        }
+        if ( position + 1 == num_events ||
+             buffer.angular_sort.starts_angle(position + 1) ) {
+          add_edge(i);
+        }
+      }
+    }
+    combination.retract();
+  }
+  return vertices;
+}
+
+} // namespace zonotope
+
+#endif // LOW_DIMENSIONAL_ZONOTOPES_HPP_
@@ -0,0 +1,309 @@
+#ifndef MATRIX_HPP_
+#define MATRIX_HPP_
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace zonotope {
+
+/**
+ * @brief A minimal allocator for storage aligned to Alignment bytes.
+ *
+ * Alignment must be a power of two and a multiple of sizeof(void*).
+ */
+template <typename T, std::size_t Alignment>
+struct Aligned_allocator {
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind {
+    typedef Aligned_allocator<U, Alignment> other;
+  };
+
+  Aligned_allocator() {}
+
+  template <typename U>
+  Aligned_allocator( const Aligned_allocator<U, Alignment>& ) {}
+
+  T* allocate( const std::size_t n ) {
+    void* p = nullptr;
+    if ( posix_memalign(&p, Alignment, n * sizeof(T)) != 0 ) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T*>(p);
+  }
+
+  void deallocate( T* p, std::size_t ) {
+    free(p);
+  }
+};
+
+template <typename T, typename U, std::size_t Alignment>
+inline bool operator== ( const Aligned_allocator<T, Alignment>&,
+                         const Aligned_allocator<U, Alignment>& ) {
+  return true;
+}
+
+template <typename T, typename U, std::size_t Alignment>
+inline bool operator!= ( const Aligned_allocator<T, Alignment>&,
+                         const Aligned_allocator<U, Alignment>& ) {
+  return false;
+}
+
+/**
+ * @brief A non-owning view of a contiguous vector of numbers.
+ *
+ * It provides the part of the std::vector interface that the
+ * algorithms use (operator[], size, begin and end), so that the rows
+ * of a Matrix can be used wherever a vector is expected. Like a
+ * pointer, the view is shallow: a const view can still modify the
+ * numbers, unless NT is const.
+ */
+template <typename NT>
+class Vector_view {
+public:
+  typedef typename std::remove_const<NT>::type value_type;
+  typedef int size_type;
+  typedef NT* iterator;
+
+  Vector_view( NT* data, const int size )
+    : data_(data)
+    , size_(size)
+    { }
+
+  /**
+   * @brief A view of non-const numbers is also a view of const numbers
+   */
+  template <typename Other_NT>
+  Vector_view( const Vector_view<Other_NT>& other )
+    : data_(other.data())
+    , size_(other.size())
+    { }
+
+  NT& operator[] ( const int i ) const {
+    return data_[i];
+  }
+
+  int size() const {
+    return size_;
+  }
+
+  NT* data() const {
+    return data_;
+  }
+
+  NT* begin() const {
+    return data_;
+  }
+
+  NT* end() const {
+    return data_ + size_;
+  }
+
+private:
+  NT* data_;
+  int size_;
+};
+
+/**
+ * @brief A non-owning view of a dense row-major matrix.
+ *
+ * Row i starts at `data + i*stride`, and consists of cols numbers.
+ * For compatibility with the vector-of-vectors representation,
+ * `size()` is the number of rows and `m[i]` is a view of row i, so
+ * that `m[i][j]`, `m.size()` and `m[0].size()` mean the same thing for
+ * both representations.
+ */
+template <typename NT>
+class Matrix_view {
+public:
+  typedef Vector_view<NT> Row_t;
+  typedef Vector_view<NT> Const_row_t;
+
+  Matrix_view( NT* data, const int rows, const int cols, const int stride )
+    : data_(data)
+    , rows_(rows)
+    , cols_(cols)
+    , stride_(stride)
+    { }
+
+  template <typename Other_NT>
+  Matrix_view( const Matrix_view<Other_NT>& other )
+    : data_(other.data())
+    , rows_(other.rows())
+    , cols_(other.cols())
+    , stride_(other.stride())
+    { }
+
+  Row_t operator[] ( const int i ) const {
+    return Row_t(data_ + i * stride_, cols_);
+  }
+
+  int size() const {
+    return rows_;
+  }
+
+  int rows() const {
+    return rows_;
+  }
+
+  int cols() const {
+    return cols_;
+  }
+
+  int stride() const {
+    return stride_;
+  }
+
+  NT* data() const {
+    return data_;
+  }
+
+private:
+  NT* data_;
+  int rows_;
+  int cols_;
+  int stride_;
+};
+
+/**
+ * @brief A dense row-major matrix in a single contiguous block.
+ *
+ * @tparam Alignment If nonzero, the storage is aligned to Alignment
+ *                   bytes, and each row is padded so that every row
+ *                   starts on such a boundary (provided that
+ *                   Alignment is a multiple of sizeof(NT)). This is
+ *                   meant for the SIMD paths on double and int64_t.
+ */
+template <typename NT, std::size_t Alignment = 0>
+class Matrix {
+public:
+  typedef Vector_view<NT> Row_t;
+  typedef Vector_view<const NT> Const_row_t;
+
+  typedef typename std::conditional< ( Alignment == 0 ),
+                                     std::allocator<NT>,
+                                     Aligned_allocator<NT, Alignment> >::type Allocator_t;
+
+  Matrix()
+    : rows_(0)
+    , cols_(0)
+    , stride_(0)
+    { }
+
+  Matrix( const int rows, const int cols, const NT& value = NT(0) )
+    : rows_(rows)
+    , cols_(cols)
+    , stride_(padded_stride(cols))
+    , data_(rows * padded_stride(cols), value)
+    { }
+
+  /**
+   * @brief Change the dimensions, reusing the current storage if it
+   *        is large enough. The contents are unspecified afterwards.
+   */
+  void resize( const int rows, const int cols ) {
+    rows_ = rows;
+    cols_ = cols;
+    stride_ = padded_stride(cols);
+    data_.resize(rows * stride_);
+  }
+
+  Row_t operator[] ( const int i ) {
+    return Row_t(data_.data() + i * stride_, cols_);
+  }
+
+  Const_row_t operator[] ( const int i ) const {
+    return Const_row_t(data_.data() + i * stride_, cols_);
+  }
+
+  int size() const {
+    return rows_;
+  }
+
+  int rows() const {
+    return rows_;
+  }
+
+  int cols() const {
+    return cols_;
+  }
+
+  int stride() const {
+    return stride_;
+  }
+
+  NT* data() {
+    return data_.data();
+  }
+
+  const NT* data() const {
+    return data_.data();
+  }
+
+  Matrix_view<NT> view() {
+    return Matrix_view<NT>(data(), rows_, cols_, stride_);
+  }
+
+  Matrix_view<const NT> view() const {
+    return Matrix_view<const NT>(data(), rows_, cols_, stride_);
+  }
+
+  /**
+   * @brief A view of the num_rows rows starting at first_row
+   */
+  Matrix_view<NT> block( const int first_row, const int num_rows ) {
+    return Matrix_view<NT>(data() + first_row * stride_, num_rows, cols_, stride_);
+  }
+
+  Matrix_view<const NT> block( const int first_row, const int num_rows ) const {
+    return Matrix_view<const NT>(data() + first_row * stride_, num_rows, cols_, stride_);
+  }
+
+  void swap_rows( const int i, const int j ) {
+    using std::swap;
+    NT* a = data() + i * stride_;
+    NT* b = data() + j * stride_;
+    for ( int c = 0; c < cols_; ++c ) {
+      swap(a[c], b[c]);
+    }
+  }
+
+  /**
+   * @brief The row stride needed to align every row
+   */
+  static int padded_stride( const int cols ) {
+    if ( Alignment == 0 || Alignment % sizeof(NT) != 0 ) {
+      return cols;
+    }
+    const int per_block = Alignment / sizeof(NT);
+    return ( ( cols + per_block - 1 ) / per_block ) * per_block;
+  }
+
+private:
+  int rows_;
+  int cols_;
+  int stride_;
+  std::vector<NT, Allocator_t> data_;
+};
+
+/**
+ * @brief Swap two rows of a matrix, in either representation
+ */
+template <typename NT>
+inline void swap_rows( std::vector<std::vector<NT> >& m, const int i, const int j ) {
+  std::swap(m[i], m[j]);
+}
+
+template <typename NT, std::size_t Alignment>
+inline void swap_rows( Matrix<NT, Alignment>& m, const int i, const int j ) {
+  m.swap_rows(i, j);
+}
+
+} // namespace zonotope
+
+#endif // MATRIX_HPP_
@@ -1,6 +1,8 @@
 #ifndef OUTPUT_FUNCTOR_BASE_HPP_
 #define OUTPUT_FUNCTOR_BASE_HPP_
 
+#include "matrix.hpp"
+
 namespace zonotope {
 
 /**
@@ -10,7 +12,7 @@ namespace zonotope {
 template <typename NT>
 struct Output_functor_base {
 
-  typedef std::vector<std::vector<NT> > Generator_container_t;
+  typedef Matrix<NT> Generator_container_t;
   
   const Generator_container_t& generators;
   const int n;
@@ -19,7 +21,7 @@ struct Output_functor_base {
   Output_functor_base(const Generator_container_t& generators)
     : generators(generators)
     , n(generators.size())
-    , d(generators[0].size())
+    , d(generators.cols())
     { }
 };
 
@@ -0,0 +1,229 @@
+#ifndef PACKED_SIGN_VECTOR_HPP_
+#define PACKED_SIGN_VECTOR_HPP_
+
+#include <cstdint>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace zonotope {
+
+/**
+ * @brief The Zobrist key of sign i, from the splitmix64 generator
+ */
+inline std::uint64_t zobrist_key(const int i) {
+  std::uint64_t z = std::uint64_t(i) * 0x9e3779b97f4a7c15ULL + 0x9e3779b97f4a7c15ULL;
+  z = ( z ^ (z >> 30) ) * 0xbf58476d1ce4e5b9ULL;
+  z = ( z ^ (z >> 27) ) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+/**
+ * @brief A sign vector of up to 64*NUM_WORDS signs in a fixed array of
+ *        words, with an incrementally updated hash.
+ *
+ * It can be used instead of std::vector<bool> as the sign vector of
+ * zonotope_vertices_dfs. The hash is the XOR of the Zobrist keys of
+ * the true signs, so flipping a sign updates it with a single XOR,
+ * and the sign vector never allocates.
+ */
+template <int NUM_WORDS>
+class Packed_sign_vector {
+public:
+  typedef std::uint64_t Word_t;
+
+  Packed_sign_vector( const int size = 0 )
+    : size_(size)
+    , hash_(0)
+  {
+    for ( int w = 0; w < NUM_WORDS; ++w ) {
+      words_[w] = 0;
+    }
+  }
+
+  Packed_sign_vector( const std::vector<bool>& signs )
+    : Packed_sign_vector( signs.size() )
+  {
+    for ( int i = 0; i < size_; ++i ) {
+      if ( signs[i] ) {
+        flip(i);
+      }
+    }
+  }
+
+  bool operator[] ( const int i ) const {
+    return ( words_[i >> 6] >> (i & 63) ) & 1;
+  }
+
+  void flip( const int i ) {
+    words_[i >> 6] ^= Word_t(1) << (i & 63);
+    hash_ ^= zobrist_key(i);
+  }
+
+  int size() const {
+    return size_;
+  }
+
+  const Word_t* words() const {
+    return words_;
+  }
+
+  std::uint64_t hash() const {
+    return hash_;
+  }
+
+  bool operator== ( const Packed_sign_vector& other ) const {
+    if ( hash_ != other.hash_ || size_ != other.size_ ) {
+      return false;
+    }
+    for ( int w = 0; w < NUM_WORDS; ++w ) {
+      if ( words_[w] != other.words_[w] ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool operator!= ( const Packed_sign_vector& other ) const {
+    return ! ( *this == other );
+  }
+
+private:
+  Word_t words_[NUM_WORDS];
+  int size_;
+  std::uint64_t hash_;
+};
+
+/**
+ * @brief An open-addressing hash set of Packed_sign_vector
+ *
+ * The words of the keys are stored inline in one flat array, next to
+ * their hashes, and collisions are resolved by linear probing. A key
+ * takes 8*(NUM_WORDS+1) bytes, and inserting allocates only when the
+ * table grows. All keys must have the same size.
+ */
+template <int NUM_WORDS>
+class Packed_sign_vector_set {
+public:
+  typedef Packed_sign_vector<NUM_WORDS> Key_t;
+  typedef std::uint64_t Word_t;
+
+  Packed_sign_vector_set()
+    : size_(0)
+  {
+    rehash(1024);
+  }
+
+  /**
+   * @brief Insert the key unless it is already in the set
+   *
+   * @return The slot of the key, and true iff it was inserted (like
+   *         std::unordered_set::insert)
+   */
+  std::pair<long, bool> insert( const Key_t& key ) {
+    if ( 2 * (size_ + 1) > capacity() ) {
+      rehash(2 * capacity());
+    }
+    const Word_t tag = stored_hash(key.hash());
+    long slot = tag & mask_;
+    while ( tags_[slot] != 0 ) {
+      if ( tags_[slot] == tag && equal_words(slot, key.words()) ) {
+        return std::make_pair(slot, false);
+      }
+      slot = ( slot + 1 ) & mask_;
+    }
+    tags_[slot] = tag;
+    const Word_t* words = key.words();
+    for ( int w = 0; w < NUM_WORDS; ++w ) {
+      words_[slot * NUM_WORDS + w] = words[w];
+    }
+    ++size_;
+    return std::make_pair(slot, true);
+  }
+
+  long size() const {
+    return size_;
+  }
+
+  long capacity() const {
+    return tags_.size();
+  }
+
+private:
+
+  /**
+   * The tag 0 marks an empty slot
+   */
+  static Word_t stored_hash( const Word_t hash ) {
+    return hash | 1;
+  }
+
+  bool equal_words( const long slot, const Word_t* words ) const {
+    for ( int w = 0; w < NUM_WORDS; ++w ) {
+      if ( words_[slot * NUM_WORDS + w] != words[w] ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void rehash( const long new_capacity ) {
+    std::vector<Word_t> old_tags;
+    std::vector<Word_t> old_words;
+    old_tags.swap(tags_);
+    old_words.swap(words_);
+    tags_.assign(new_capacity, 0);
+    words_.resize(new_capacity * NUM_WORDS);
+    mask_ = new_capacity - 1;
+
+    const long old_capacity = old_tags.size();
+    for ( long old_slot = 0; old_slot < old_capacity; ++old_slot ) {
+      const Word_t tag = old_tags[old_slot];
+      if ( tag == 0 ) {
+        continue;
+      }
+      long slot = tag & mask_;
+      while ( tags_[slot] != 0 ) {
+        slot = ( slot + 1 ) & mask_;
+      }
+      tags_[slot] = tag;
+      for ( int w = 0; w < NUM_WORDS; ++w ) {
+        words_[slot * NUM_WORDS + w] = old_words[old_slot * NUM_WORDS + w];
+      }
+    }
+  }
+
+  long size_;
+  long mask_;
+  std::vector<Word_t> tags_;
+  std::vector<Word_t> words_;
+};
+
+/**
+ * @brief The set of visited sign vectors of zonotope_vertices_dfs
+ */
+template <typename Sign_vector_t>
+struct Visited_sign_vector_set {
+  typedef std::unordered_set<Sign_vector_t> type;
+};
+
+template <int NUM_WORDS>
+struct Visited_sign_vector_set<Packed_sign_vector<NUM_WORDS> > {
+  typedef Packed_sign_vector_set<NUM_WORDS> type;
+};
+
+/**
+ * @brief Flip the sign k of a sign vector
+ */
+inline void flip_sign(std::vector<bool>& sign_vector, const int k) {
+  sign_vector[k] = ( ! sign_vector[k] );
+}
+
+template <int NUM_WORDS>
+inline void flip_sign(Packed_sign_vector<NUM_WORDS>& sign_vector, const int k) {
+  sign_vector.flip(k);
+}
+
+} // namespace zonotope
+
+#endif // PACKED_SIGN_VECTOR_HPP_
@@ -0,0 +1,133 @@
+#ifndef PARALLEL_COMBINATION_TRAVERSAL_HPP_
+#define PARALLEL_COMBINATION_TRAVERSAL_HPP_
+
+#include "combination_traversal.hpp"
+#include "work_stealing.hpp"
+
+#include <vector>
+
+namespace zonotope {
+
+/**
+ * @brief Collect the roots of the traversal subtrees at depth split_depth.
+ *
+ * Behaves like traverse_combinations_in_place, except that it stops
+ * at the combinations of size split_depth and stores copies of them in
+ * prefixes instead of handing them to the output functor. The span
+ * marks are not used above the split, where there are few combinations.
+ */
+template <typename Combination_container,
+          typename Output_functor>
+void collect_combination_prefixes (
+  Combination_container& current_combination,
+  Output_functor& output,
+  const int split_depth,
+  std::vector<Combination_container>& prefixes,
+  Combination_traversal_statistics* statistics = nullptr )
+{
+  if ( int(current_combination.size()) >= split_depth ) {
+    prefixes.push_back(current_combination);
+    return;
+  }
+
+  if ( statistics ) {
+    ++statistics->num_combinations;
+  }
+  if ( output(current_combination) ) {
+    // the current combination is a leaf and has been handled
+    return;
+  }
+
+  const int begin = current_combination.next_elements_begin();
+  const int end = current_combination.next_elements_end();
+
+  for ( int i = begin; i < end; ++i ) {
+    current_combination.extend(i);
+    if ( current_combination.is_valid() ) {
+      collect_combination_prefixes(current_combination, output, split_depth, prefixes, statistics);
+    }
+    current_combination.retract();
+  }
+}
+
+/**
+ * @brief Choose a split depth with enough subtrees to keep num_threads
+ *        workers busy.
+ *
+ * Returns the smallest k < max_size such that there are at least
+ * 16*num_threads k-combinations of n elements.
+ */
+inline int default_split_depth( const int n,
+                                const int max_size,
+                                const int num_threads )
+{
+  const double target = 16.0 * num_threads;
+  double num_prefixes = 1;
+  int k = 0;
+  while ( ( k + 1 < max_size ) && ( num_prefixes < target ) ) {
+    num_prefixes = num_prefixes * (n - k) / (k + 1);
+    ++k;
+  }
+  return k;
+}
+
+/**
+ * @brief A parallel version of traverse_combinations_in_place.
+ *
+ * The combinations of size split_depth are built once, sequentially,
+ * and the subtrees rooted at them are then traversed in place by a
+ * pool of work-stealing workers, one for each output functor.
+ *
+ * @param outputs One output functor per worker thread. Worker t only
+ *                ever calls outputs[t], and outputs[0] additionally
+ *                handles the combinations of size less than
+ *                split_depth. It is up to the caller to combine the
+ *                results of the output functors afterwards.
+ *
+ * @param split_depth The depth of the subtree roots that are
+ *                    distributed among the workers.
+ *
+ * @param statistics If set, the counts of all workers are added to it.
+ */
+template <typename Combination_container,
+          typename Output_functor>
+void traverse_combinations_parallel (
+  const Combination_container& root_combination,
+  std::vector<Output_functor>& outputs,
+  const int split_depth,
+  Combination_traversal_statistics* statistics = nullptr )
+{
+  const int num_threads = outputs.size();
+
+  Combination_container current_combination ( root_combination );
+  std::vector<Combination_container> prefixes;
+  collect_combination_prefixes( current_combination,
+                                outputs[0],
+                                split_depth,
+                                prefixes,
+                                statistics );
+
+  // every worker reuses its marks for all of its subtrees
+  std::vector<Combination_span_marks> marks
+    (num_threads, Combination_span_marks(root_combination.MAX_ELEMENT));
+  std::vector<Combination_traversal_statistics> worker_statistics (num_threads);
+
+  auto traverse_prefix = [&] ( const int task,
+                               const int thread_index ) {
+    traverse_combinations_in_place<Combination_container, Output_functor>
+      ( prefixes[task], outputs[thread_index], marks[thread_index],
+        statistics ? &worker_statistics[thread_index] : nullptr );
+  };
+
+  parallel_for_each_task( prefixes.size(), num_threads, traverse_prefix );
+
+  if ( statistics ) {
+    for ( const Combination_traversal_statistics& s : worker_statistics ) {
+      *statistics += s;
+    }
+  }
+}
+
+} // namespace zonotope
+
+#endif // PARALLEL_COMBINATION_TRAVERSAL_HPP_
@@ -0,0 +1,182 @@
+#ifndef _PARALLEL_REVERSE_SEARCH_HPP__
+#define _PARALLEL_REVERSE_SEARCH_HPP__
+
+#include "work_stealing.hpp"
+
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief The shared queue of unexplored subtrees of
+ *        parallel_reverse_search
+ *
+ * A job is the root of a subtree of the reverse search tree. The
+ * search is done once the queue is empty and no worker is exploring a
+ * subtree (which could still add jobs).
+ */
+template <typename Vertex>
+struct Reverse_search_job_queue {
+  std::mutex lock;
+  std::condition_variable changed;
+  std::deque<Vertex> jobs;
+  int active_workers;
+
+  Reverse_search_job_queue() : active_workers(0) {}
+
+  void push( const Vertex& v ) {
+    std::lock_guard<std::mutex> guard ( lock );
+    jobs.push_back(v);
+    changed.notify_one();
+  }
+
+  /**
+   * @brief Wait for the next job.
+   *
+   * @return false iff the search is done. Otherwise the job is stored
+   *         in v, and the worker must call finish() once it has
+   *         explored the subtree.
+   */
+  bool pop( Vertex& v ) {
+    std::unique_lock<std::mutex> guard ( lock );
+    while ( jobs.empty() ) {
+      if ( active_workers == 0 ) {
+        return false;
+      }
+      changed.wait(guard);
+    }
+    v = jobs.front();
+    jobs.pop_front();
+    ++active_workers;
+    return true;
+  }
+
+  void finish() {
+    std::lock_guard<std::mutex> guard ( lock );
+    --active_workers;
+    if ( active_workers == 0 && jobs.empty() ) {
+      // wake up the idle workers, so that they can return
+      changed.notify_all();
+    }
+  }
+};
+
+/**
+ * @brief Explore the reverse search subtree rooted at root, but only
+ *        descend into the first `budget` vertices. The roots of the
+ *        subtrees that are left unexplored are pushed to the queue.
+ *
+ * Every vertex of the subtree is either passed to output or is in a
+ * subtree that is pushed to the queue, exactly once.
+ */
+template <typename Adjacency_oracle,
+          typename Finite_local_search,
+          typename Vertex,
+          typename Output_functor>
+inline void budgeted_reverse_search(
+    const Adjacency_oracle& isAdjacent,
+    const int max_degree,
+    const Vertex& root,
+    const Vertex& NONE,
+    const Finite_local_search& f,
+    const long budget,
+    Reverse_search_job_queue<Vertex>& queue,
+    Output_functor& output)
+{
+  Vertex current_vertex = root;
+  int neighbor_counter = 0;
+  long visited = 1;
+  output(root);
+  do {
+    while ( neighbor_counter < max_degree ) {
+      ++neighbor_counter;
+      const Vertex next_vertex = isAdjacent(current_vertex, neighbor_counter);
+      if ( ( next_vertex != NONE ) && ( f(next_vertex) == current_vertex ) ) {
+        if ( visited >= budget ) {
+          // hand the subtree of next_vertex off to another worker
+          queue.push(next_vertex);
+          continue;
+        }
+        // reverse traverse (with respect to f)
+        current_vertex = next_vertex;
+        neighbor_counter = 0;
+        ++visited;
+        output(current_vertex);
+      }
+    }
+    if ( current_vertex != root ) {
+      // forward traverse (with respect to f)
+      const Vertex prev_vertex = current_vertex;
+      current_vertex = f(current_vertex);
+      neighbor_counter = 0;
+      do {
+        // restore neighbor_counter
+        ++neighbor_counter;
+      } while ( isAdjacent(current_vertex, neighbor_counter) != prev_vertex );
+    }
+  } while ( ( current_vertex != root ) || ( neighbor_counter != max_degree ) );
+}
+
+/**
+ * @brief A parallel version of reverse_search, which distributes the
+ *        subtrees of the reverse search tree over several threads.
+ *
+ * As in mplrs, each worker explores the subtree of a job depth-first,
+ * until it has output `budget` vertices. After that, it keeps
+ * backtracking to the root of the job, but instead of descending into
+ * the unexplored children, it pushes them to a shared queue, from
+ * which the idle workers take their next jobs.
+ *
+ * The adjacency oracle and the local search take the same form as in
+ * reverse_search. They are shared by all workers, so calling them
+ * must be thread-safe. Every worker has its own output functor,
+ * outputs[thread_index], and the number of workers is outputs.size(),
+ * which must be at least 1.
+ * To collect all vertices in one place, the output functors can
+ * forward them to a shared, locked container.
+ *
+ * The vertices are output in preorder within each job, and in no
+ * particular order overall.
+ */
+template <typename Adjacency_oracle,
+          typename Finite_local_search,
+          typename Vertex,
+          typename Output_functor>
+inline void parallel_reverse_search(
+    const Adjacency_oracle& isAdjacent,
+    const int max_degree,
+    const Vertex& sink,
+    const Vertex& NONE,
+    const Finite_local_search& f,
+    std::vector<Output_functor>& outputs,
+    const long budget = 1000)
+{
+  assert( ! outputs.empty() );
+  const int num_threads = outputs.size();
+
+  Reverse_search_job_queue<Vertex> queue;
+  queue.push(sink);
+
+  auto worker = [&] ( const int thread_index ) {
+    Vertex root;
+    while ( queue.pop(root) ) {
+      budgeted_reverse_search( isAdjacent, max_degree, root, NONE, f,
+                               budget, queue, outputs[thread_index] );
+      queue.finish();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for ( int t = 1; t < num_threads; ++t ) {
+    threads.push_back( std::thread(worker, t) );
+  }
+  worker(0);
+  for ( std::thread& thread : threads ) {
+    thread.join();
+  }
+}
+
+#endif // _PARALLEL_REVERSE_SEARCH_HPP__
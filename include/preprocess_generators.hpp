@@ -1,7 +1,13 @@
 #ifndef PREPROCESS_GENERATORS_HPP_
 #define PREPROCESS_GENERATORS_HPP_
 
+#include "matrix.hpp"
+#include "standardize_vector.hpp"
+
+#include <cstddef>
 #include <gmpxx.h>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace zonotope {
@@ -13,21 +19,23 @@ namespace zonotope {
  *
  *     generators_out = cast(scaling_factor * generators_in)
  *
- * with scaling_factor as small as possible.
+ * with scaling_factor as small as possible. The output is stored in a
+ * flat n-by-d Matrix, which is the layout used by the algorithms. Its
+ * storage is reused if it is large enough.
  *
  */
 template <typename User_number_t,
           typename Internal_number_t>
 void preprocess_generators (
   const std::vector<std::vector<User_number_t> >& generators_in,
-  std::vector<std::vector<Internal_number_t> >& generators_out,
+  Matrix<Internal_number_t>& generators_out,
   Internal_number_t& scaling_factor )
 {
 
   const int d = generators_in[0].size();
   const int n = generators_in.size();
 
-  generators_out = std::vector<std::vector<Internal_number_t> > (n, std::vector<Internal_number_t> (d) );
+  generators_out.resize(n, d);
   scaling_factor = 1;
 
   for ( int k = 0; k < n; ++k ) {
@@ -41,22 +49,22 @@ template <typename User_number_t,
           typename Internal_number_t>
 void preprocess_generators (
   const std::vector<std::vector<User_number_t> >& generators_in,
-  std::vector<std::vector<Internal_number_t> >& generators_out)
+  Matrix<Internal_number_t>& generators_out)
 {
   Internal_number_t scaling_factor;
   preprocess_generators(generators_in, generators_out, scaling_factor);
 }
 
 template <>
-void
+inline void
 preprocess_generators<mpq_class, mpz_class> (
   const std::vector<std::vector<mpq_class> >& generators_in,
-  std::vector<std::vector<mpz_class> >& generators_out,
+  Matrix<mpz_class>& generators_out,
   mpz_class& scaling_factor)
 {
   const int d = generators_in[0].size();
   const int n = generators_in.size();
-  generators_out = std::vector<std::vector<mpz_class> > (n, std::vector<mpz_class> (d) );
+  generators_out.resize(n, d);
 
   mpz_class generators_den_lcm = generators_in[0][0].get_den();
   for ( const auto& v : generators_in ) {
@@ -78,10 +86,10 @@ preprocess_generators<mpq_class, mpz_class> (
 }
 
 template <>
-void
+inline void
 preprocess_generators<double, mpz_class> (
     const std::vector<std::vector<double> >& generators_in,
-    std::vector<std::vector<mpz_class> >& generators_out,
+    Matrix<mpz_class>& generators_out,
     mpz_class& scaling_factor ) {
 
   const int d = generators_in[0].size();
@@ -96,6 +104,223 @@ preprocess_generators<double, mpz_class> (
   preprocess_generators<mpq_class, mpz_class> (generators_mpq, generators_out, scaling_factor);
 }
 
+/**
+ * @brief true for the integer types whose parallel generators can be
+ *        grouped exactly (see group_parallel_generators), i.e. the
+ *        types with a _gcd and a _hash_number
+ */
+template <typename Number_t>
+struct Is_integral_number : std::false_type {};
+
+template <>
+struct Is_integral_number<long> : std::true_type {};
+
+template <>
+struct Is_integral_number<mpz_class> : std::true_type {};
+
+template <typename Number_t>
+inline std::size_t _hash_number(const Number_t& x);
+
+template <>
+inline std::size_t _hash_number<long>(const long& x) {
+  return std::size_t(x);
+}
+
+template <>
+inline std::size_t _hash_number<mpz_class>(const mpz_class& x) {
+  // the lowest limb and the sign
+  return std::size_t(mpz_getlimbn(x.get_mpz_t(), 0)) * 2 + ( sgn(x) < 0 );
+}
+
+template <typename Number_t>
+struct _Vector_hash {
+  std::size_t operator() (const std::vector<Number_t>& v) const {
+    std::size_t h = 14695981039346656037ULL;
+    for ( const Number_t& x : v ) {
+      h = ( h ^ _hash_number<Number_t>(x) ) * 1099511628211ULL;
+    }
+    return h;
+  }
+};
+
+/**
+ * @brief The classes of parallel generators of a zonotope
+ *
+ * The generators in class c are the nonzero integer multiples
+ * lambda*directions[c] of a primitive vector, oriented like the first
+ * generator of the class. The segments [0, lambda*directions[c]] of a
+ * class add up to
+ *
+ *     [0, weights[c]*directions[c]] + (the generators with lambda < 0),
+ *
+ * where weights[c] is the sum of |lambda|. So the zonotope is the
+ * zonotope of the merged generators weights[c]*directions[c] (one per
+ * class, see merged_generators), translated by `translation`, the sum
+ * of all the generators with lambda < 0. In particular, both have the
+ * same volume, the same facet normals and the same f-vector.
+ */
+template <typename Number_t>
+struct Parallel_generator_classes {
+
+  std::vector<std::vector<Number_t> > directions;
+  std::vector<Number_t> weights;
+
+  /**
+   * class_of[i] is the class of generator i, or -1 if it is zero, and
+   * reversed[i] is true iff its lambda is negative
+   */
+  std::vector<int> class_of;
+  std::vector<bool> reversed;
+
+  std::vector<Number_t> translation;
+
+  int size() const {
+    return directions.size();
+  }
+
+  /**
+   * @brief Store the merged generators in the rows of merged
+   */
+  void merged_generators(Matrix<Number_t>& merged) const {
+    const int d = translation.size();
+    merged.resize(size(), d);
+    for ( int c = 0; c < size(); ++c ) {
+      for ( int j = 0; j < d; ++j ) {
+        merged[c][j] = weights[c] * directions[c][j];
+      }
+    }
+  }
+};
+
+/**
+ * @brief Group integral generators into classes of parallel generators
+ *
+ * Every generator is reduced to its primitive direction with
+ * standardize_vector, and the directions (up to sign) are looked up in
+ * a hash table, so that grouping takes O(n*d) arithmetic operations in
+ * expectation. The classes are numbered in the order of their first
+ * generators.
+ */
+template <typename Number_t,
+          typename Generators_t>
+void group_parallel_generators (
+  const Generators_t& generators,
+  Parallel_generator_classes<Number_t>& classes )
+{
+  static_assert( Is_integral_number<Number_t>::value,
+                 "parallel generators can only be grouped for integral number types" );
+
+  const int n = generators.size();
+  const int d = generators[0].size();
+
+  classes.directions.clear();
+  classes.weights.clear();
+  classes.class_of.assign(n, -1);
+  classes.reversed.assign(n, false);
+  classes.translation.assign(d, Number_t(0));
+
+  // the class of every direction, oriented so that its first nonzero
+  // coordinate is positive, and whether the class has that orientation
+  std::unordered_map<std::vector<Number_t>, std::pair<int, bool>, _Vector_hash<Number_t> > class_of_direction;
+  class_of_direction.reserve(n);
+
+  std::vector<Number_t> key (d);
+  Number_t lambda;
+  for ( int i = 0; i < n; ++i ) {
+    const auto& g = generators[i];
+    for ( int j = 0; j < d; ++j ) {
+      key[j] = g[j];
+    }
+    standardize_vector<Number_t> (key, lambda);
+    if ( lambda < 0 ) {
+      // g = 0
+      continue;
+    }
+    int first_nonzero = 0;
+    while ( key[first_nonzero] == 0 ) {
+      ++first_nonzero;
+    }
+    const bool negative = ( key[first_nonzero] < 0 );
+    if ( negative ) {
+      for ( Number_t& x : key ) {
+        x = -x;
+      }
+    }
+
+    const auto inserted = class_of_direction.insert(
+      std::make_pair( key, std::make_pair( classes.size(), negative ) ) );
+    const int c = inserted.first->second.first;
+    if ( inserted.second ) {
+      classes.directions.push_back(key);
+      if ( negative ) {
+        for ( Number_t& x : classes.directions.back() ) {
+          x = -x;
+        }
+      }
+      classes.weights.push_back(lambda);
+    } else {
+      classes.weights[c] += lambda;
+      if ( negative != inserted.first->second.second ) {
+        classes.reversed[i] = true;
+        for ( int j = 0; j < d; ++j ) {
+          classes.translation[j] += g[j];
+        }
+      }
+    }
+    classes.class_of[i] = c;
+  }
+}
+
+template <typename Number_t>
+inline bool _merge_parallel_generators (
+  Matrix<Number_t>& generators,
+  std::vector<Number_t>& translation,
+  std::true_type )
+{
+  Parallel_generator_classes<Number_t> classes;
+  group_parallel_generators(generators, classes);
+  if ( classes.size() == generators.rows() ) {
+    // no two generators are parallel, and none is zero
+    return false;
+  }
+  classes.merged_generators(generators);
+  translation.swap(classes.translation);
+  return true;
+}
+
+template <typename Number_t>
+inline bool _merge_parallel_generators (
+  Matrix<Number_t>&,
+  std::vector<Number_t>&,
+  std::false_type )
+{
+  return false;
+}
+
+/**
+ * @brief Replace the internal generators by one merged generator per
+ *        class of parallel generators (see Parallel_generator_classes).
+ *
+ * The zonotope of the original generators is that of the merged ones,
+ * translated by `translation`. Nothing is merged for the number types
+ * that are not integral (double), where parallelism cannot be tested
+ * exactly.
+ *
+ * @return true iff the generators were replaced. Otherwise,
+ *         translation is left as it is.
+ */
+template <typename Number_t>
+bool merge_parallel_generators_in_place (
+  Matrix<Number_t>& generators,
+  std::vector<Number_t>& translation )
+{
+  if ( generators.rows() == 0 ) {
+    return false;
+  }
+  return _merge_parallel_generators
+    (generators, translation, typename Is_integral_number<Number_t>::type());
+}
+
 } // namespace zonotope
 
 #endif // PREPROCESS_GENERATORS_HPP_
@@ -1,6 +1,13 @@
 #ifndef _REVERSE_SEARCH_HPP__
 #define _REVERSE_SEARCH_HPP__
 
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 // TODO: Consider using an output stream instead of a normal functor.
 
 template <typename Adjacency_oracle,
@@ -42,4 +49,187 @@ inline void reverse_search(
   output(sink);
 }
 
+/**
+ * @brief Same traversal and output order as reverse_search, but the
+ *        ancestors of the current vertex are kept on an explicit stack,
+ *        together with their neighbor counters.
+ *
+ * Backtracking then pops the parent and its neighbor_counter, instead
+ * of computing the parent with f and restoring the counter with up to
+ * max_degree calls to the adjacency oracle. The stack takes O(depth)
+ * memory, where the depth of the reverse search tree is at most the
+ * number of steps that f takes to reach the sink (at most n for the
+ * sign vectors of cell and vertex enumeration).
+ */
+template <typename Adjacency_oracle,
+         typename Finite_local_search,
+         typename Vertex,
+         typename Output_functor>
+inline void reverse_search_with_stack(
+    const Adjacency_oracle& isAdjacent,
+    const int max_degree,
+    const Vertex& sink,
+    const Vertex& NONE,
+    const Finite_local_search& f,
+    Output_functor& output)
+{
+  std::vector<std::pair<Vertex, int> > ancestors;
+  Vertex current_vertex = sink;
+  int neighbor_counter = 0;
+  while ( true ) {
+    while ( neighbor_counter < max_degree ) {
+      ++neighbor_counter;
+      Vertex next_vertex = isAdjacent(current_vertex, neighbor_counter);
+      if ( ( next_vertex != NONE ) && ( f(next_vertex) == current_vertex ) ) {
+        // reverse traverse (with respect to f)
+        ancestors.push_back(std::make_pair(std::move(current_vertex), neighbor_counter));
+        current_vertex = std::move(next_vertex);
+        neighbor_counter = 0;
+      }
+    }
+    output(current_vertex);
+    if ( ancestors.empty() ) {
+      // current_vertex is the sink
+      break;
+    }
+    // forward traverse (with respect to f)
+    current_vertex = std::move(ancestors.back().first);
+    neighbor_counter = ancestors.back().second;
+    ancestors.pop_back();
+  }
+}
+
+/**
+ * @brief A map with a bounded number of entries, which evicts the least
+ *        recently used entry when it is full.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key> >
+class Lru_cache {
+public:
+  Lru_cache( const std::size_t capacity )
+    : capacity_(capacity)
+  {
+    index_.reserve(capacity);
+  }
+
+  /**
+   * @brief The value of key, or nullptr if it is not in the cache
+   *
+   * The pointer is valid until the next insert.
+   */
+  const Value* find( const Key& key ) {
+    const auto it = index_.find(key);
+    if ( it == index_.end() ) {
+      return nullptr;
+    }
+    // move the entry to the front
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return &(it->second->second);
+  }
+
+  /**
+   * @brief Add an entry for a key that is not in the cache
+   */
+  void insert( const Key& key, const Value& value ) {
+    if ( capacity_ == 0 ) {
+      return;
+    }
+    if ( index_.size() == capacity_ ) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+    entries_.push_front(std::make_pair(key, value));
+    index_[key] = entries_.begin();
+  }
+
+  std::size_t size() const {
+    return index_.size();
+  }
+
+private:
+  typedef std::list<std::pair<Key, Value> > Entry_list_t;
+
+  std::size_t capacity_;
+  Entry_list_t entries_;
+  std::unordered_map<Key, typename Entry_list_t::iterator, Hash> index_;
+};
+
+/**
+ * @brief Wraps a local search f with a cache of its `capacity` most
+ *        recently used results.
+ *
+ * reverse_search computes f of every candidate child, and f of the
+ * current vertex on every backtrack, and a vertex is a candidate child
+ * of each of its neighbors. When f is expensive (for cell enumeration
+ * it may solve up to n linear programs), most of these calls can be
+ * answered from the cache.
+ *
+ * The cache is modified by the queries, so an instance must not be
+ * shared between threads.
+ */
+template <typename Finite_local_search,
+          typename Vertex,
+          typename Hash = std::hash<Vertex> >
+struct Cached_local_search {
+  const Finite_local_search& f;
+  mutable Lru_cache<Vertex, Vertex, Hash> cache;
+
+  Cached_local_search( const Finite_local_search& f,
+                       const std::size_t capacity = 4096 )
+    : f(f)
+    , cache(capacity)
+    { }
+
+  Vertex operator() (const Vertex& v) const {
+    const Vertex* cached = cache.find(v);
+    if ( cached ) {
+      return *cached;
+    }
+    Vertex result = f(v);
+    cache.insert(v, result);
+    return result;
+  }
+};
+
+/**
+ * @brief The hash of a (vertex, neighbor_counter) query
+ */
+template <typename Vertex, typename Hash = std::hash<Vertex> >
+struct Neighbor_query_hash {
+  std::size_t operator() (const std::pair<Vertex, int>& query) const {
+    return Hash()(query.first) * 31 + std::hash<int>()(query.second);
+  }
+};
+
+/**
+ * @brief Wraps an adjacency oracle with a cache of its `capacity` most
+ *        recently used results, like Cached_local_search.
+ */
+template <typename Adjacency_oracle,
+          typename Vertex,
+          typename Hash = std::hash<Vertex> >
+struct Cached_adjacency_oracle {
+  typedef std::pair<Vertex, int> Query_t;
+
+  const Adjacency_oracle& isAdjacent;
+  mutable Lru_cache<Query_t, Vertex, Neighbor_query_hash<Vertex, Hash> > cache;
+
+  Cached_adjacency_oracle( const Adjacency_oracle& isAdjacent,
+                           const std::size_t capacity = 4096 )
+    : isAdjacent(isAdjacent)
+    , cache(capacity)
+    { }
+
+  Vertex operator() (const Vertex& v, const int neighbor_counter) const {
+    const Query_t query (v, neighbor_counter);
+    const Vertex* cached = cache.find(query);
+    if ( cached ) {
+      return *cached;
+    }
+    Vertex result = isAdjacent(v, neighbor_counter);
+    cache.insert(query, result);
+    return result;
+  }
+};
+
 #endif
@@ -15,16 +15,32 @@ inline void _gcd<mpz_class>(mpz_class& a, const mpz_class& b) {
   mpz_gcd( a.get_mpz_t(), a.get_mpz_t(), b.get_mpz_t() );
 }
 
+template <>
+inline void _gcd<long>(long& a, const long& b) {
+  long x = ( a < 0 ) ? -a : a;
+  long y = ( b < 0 ) ? -b : b;
+  while ( y != 0 ) {
+    const long r = x % y;
+    x = y;
+    y = r;
+  }
+  a = x;
+}
+
 /**
  * Standardize a vector of integers
  *
  * @param numbers The input vector of integers
+ * @param a On exit, the gcd of the entries (or -1 if they are all 0)
  * @post The numbers vector has been reduced by the gcd of its entries
+ *
+ * This variant computes the gcd in a caller-provided number, so that
+ * it can be called in a loop without allocating a new number each
+ * time.
  */
-
 template <typename Number_t, typename Vector_t>
-inline Number_t standardize_vector ( Vector_t& numbers ) {
-  Number_t a = numbers[0];
+inline void standardize_vector ( Vector_t& numbers, Number_t& a ) {
+  a = numbers[0];
   for ( const Number_t& b : numbers ) {
     if ( a == 0 ) {
       if ( b == 0 ) {
@@ -35,19 +51,33 @@ inline Number_t standardize_vector ( Vector_t& numbers ) {
     _gcd<Number_t> ( a, b );
     // a = gcd(a,b) > 0
     if ( a == 1 ) {
-      return a;
+      return;
     }
   }
   // a = gcd(numbers)
  
   if ( a == 0 ) {
     // NOTE: This is a degenerate case, where all the numbers are 0
-    return -1;
+    a = -1;
+    return;
   }
   for ( Number_t& b : numbers ) { 
     b /= a;
   }
   // numbers = numbers / a
+}
+
+/**
+ * Standardize a vector of integers
+ *
+ * @param numbers The input vector of integers
+ * @post The numbers vector has been reduced by the gcd of its entries
+ */
+
+template <typename Number_t, typename Vector_t>
+inline Number_t standardize_vector ( Vector_t& numbers ) {
+  Number_t a;
+  standardize_vector<Number_t, Vector_t> ( numbers, a );
   return a;
 }
 
@@ -39,6 +39,13 @@ struct Type_casting_functor<mpz_class, double> {
   }
 };
 
+template <>
+struct Type_casting_functor<mpq_class, double> {
+  double operator() (const mpq_class& val) const {
+    return val.get_d();
+  }
+};
+
 template<>
 struct Type_casting_functor<std::vector<long>, std::vector<mpz_class> > {
   std::vector<mpz_class> operator() (const std::vector<long>& v_long ) const {
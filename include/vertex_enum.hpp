@@ -4,6 +4,9 @@
 // inspired by cell_enum.hpp
 
 #include "linalg.hpp"
+#include "packed_sign_vector.hpp"
+#include "preprocess_generators.hpp"
+#include "low_dimensional_zonotopes.hpp"
 
 // STL dependencies
 #include <vector>
@@ -25,8 +28,9 @@ struct Sign_flip_functor {
 
   Sign_flip_functor(const Adjacency_oracle_t& adj) : adj_(adj) {}
 
+  template <typename Sign_vector_t>
   void operator() (typename Adjacency_oracle_t::Vector_t& v,
-                   typename Adjacency_oracle_t::Cell_t& sign_vector,
+                   Sign_vector_t& sign_vector,
                    int k) const
   {
     for ( int j = 0; j < adj_.d_; ++j ) {
@@ -38,24 +42,29 @@ struct Sign_flip_functor {
         v[j] -= adj_.generators_[k].second[j];
       }
     }
-    sign_vector[k] = ( ! sign_vector[k] );
+    flip_sign(sign_vector, k);
   }
 };
 
+/**
+ * The sign vector can be a std::vector<bool> or a Packed_sign_vector,
+ * and the visited sign vectors are stored in the corresponding
+ * Visited_sign_vector_set.
+ */
 template <typename Number_t,
           typename Adjacency_oracle_t,
-          typename Flip_functor_t = Sign_flip_functor<Adjacency_oracle_t> >
+          typename Flip_functor_t = Sign_flip_functor<Adjacency_oracle_t>,
+          typename Sign_vector_t = std::vector<bool> >
 std::vector<std::vector<Number_t> >
 zonotope_vertices_dfs (
     std::vector<Number_t>& current_vertex, // the starting vertex
-    std::vector<bool>& sign_vector,
+    Sign_vector_t& sign_vector,
     const Flip_functor_t& flip,
     const Adjacency_oracle_t& is_adjacent  ) // the sign vector of the starting vertex
 {
   using std::stack;
   using std::vector;
   using std::pair;
-  using std::unordered_set;
 
   vector<vector<Number_t> > vertices;
   stack<pair<int, int> > sign_flip_stack;
@@ -63,7 +72,7 @@ zonotope_vertices_dfs (
 
   const int n = is_adjacent.n_;
 
-  unordered_set<vector<bool> > visited_cells;
+  typename Visited_sign_vector_set<Sign_vector_t>::type visited_cells;
   visited_cells.insert(sign_vector);
   vertices.push_back(current_vertex);
 
@@ -83,10 +92,9 @@ zonotope_vertices_dfs (
 
         flip(current_vertex, sign_vector, child_flip_index);
 
-        if ( visited_cells.find(sign_vector) == visited_cells.end() ) {
+        if ( visited_cells.insert(sign_vector).second ) {
           // this is the first time we see current_vertex, so we push to the flip to the stack
           vertices.push_back(current_vertex);
-          visited_cells.insert(sign_vector);
 
           sign_flip_stack.push( pair<int,int> (child_flip_index, -1) );
           break;
@@ -110,15 +118,20 @@ zonotope_vertices_dfs (
 }
 
 
-template <typename Number_t, typename Adjacency_oracle_t >
-std::vector<std::vector<Number_t> >
-zonotope_vertices (const std::vector<std::vector<Number_t> >& generators)
+/**
+ * @brief merge_parallel_generators for the number types that are not
+ *        integral, by comparing all pairs of generators
+ */
+template <typename Number_t>
+std::vector<std::pair<std::vector<Number_t>, std::vector<Number_t> > >
+_merge_parallel_generators (const std::vector<std::vector<Number_t> >& generators,
+                            std::false_type)
 {
   using std::vector;
   using std::pair;
   typedef vector<Number_t> Vector_t;
   typedef pair<Vector_t, Vector_t> Segment_t;
-  
+
   const int d = generators[0].size();
 
   //
@@ -127,7 +140,7 @@ zonotope_vertices (const std::vector<std::vector<Number_t> >& generators)
   const int m = generators.size();
   vector<bool> handled (m, false);
 
-  vector<Segment_t> _generators; // the internal representation of the generators
+  vector<Segment_t> _generators;
   
   for ( int i = 0; i < m; ++i ) {
     // look for codirectional vectors
@@ -161,6 +174,10 @@ zonotope_vertices (const std::vector<std::vector<Number_t> >& generators)
           break;
         }
       }
+      if ( s == d ) {
+        // u and v have no common nonzero coordinate
+        continue;
+      }
       for ( r = 0; r < d; ++r ) {
         if ( u[s] * v[r] != u[r] * v[s] ) {
           break;
@@ -194,37 +211,221 @@ zonotope_vertices (const std::vector<std::vector<Number_t> >& generators)
     handled[i] = true;
   }
 
+  return _generators;
+}
+
+/**
+ * @brief merge_parallel_generators for the integral number types, with
+ *        the classes of group_parallel_generators
+ */
+template <typename Number_t>
+std::vector<std::pair<std::vector<Number_t>, std::vector<Number_t> > >
+_merge_parallel_generators (const std::vector<std::vector<Number_t> >& generators,
+                            std::true_type)
+{
+  typedef std::vector<Number_t> Vector_t;
+  typedef std::pair<Vector_t, Vector_t> Segment_t;
+
+  const int n = generators.size();
+  const int d = generators[0].size();
+
+  Parallel_generator_classes<Number_t> classes;
+  group_parallel_generators(generators, classes);
+
+  std::vector<Segment_t> segments (classes.size(),
+                                   Segment_t(Vector_t(d, Number_t(0)), Vector_t(d, Number_t(0))));
+  for ( int i = 0; i < n; ++i ) {
+    const int c = classes.class_of[i];
+    if ( c < 0 ) {
+      continue;
+    }
+    Vector_t& sum = classes.reversed[i] ? segments[c].second : segments[c].first;
+    for ( int r = 0; r < d; ++r ) {
+      sum[r] += generators[i][r];
+    }
+  }
+  return segments;
+}
+
+/**
+ * @brief Merge the parallel generators into segments
+ *
+ * The zonotope is the sum of the segments [second, first], where first
+ * is the sum of the generators in one direction and second the sum of
+ * the generators in the opposite direction. The vertex with sign
+ * vector s is the sum of first (if s[i]) or second (otherwise) over
+ * the segments i. Zero generators are dropped.
+ *
+ * The segments are in the order of their first generators, and first
+ * has the direction of that generator. For the integral number types,
+ * the generators are grouped by hashing (see group_parallel_generators)
+ * in O(n*d) expected time, and otherwise by comparing all pairs.
+ */
+template <typename Number_t>
+std::vector<std::pair<std::vector<Number_t>, std::vector<Number_t> > >
+merge_parallel_generators (const std::vector<std::vector<Number_t> >& generators)
+{
+  return _merge_parallel_generators
+    (generators, typename Is_integral_number<Number_t>::type());
+}
+
+/**
+ * @brief The sign vector of the vertex that maximizes the direction
+ *        (1, e, e^2, ..., e^(d-1)) for a small enough e > 0.
+ *
+ * The direction lies on no hyperplane of the arrangement, and its dot
+ * product with a segment has the sign of the first nonzero coordinate
+ * of the segment.
+ */
+template <typename Segment_t>
+std::vector<bool>
+initial_sign_vector (const std::vector<Segment_t>& segments)
+{
+  const int n = segments.size();
+  std::vector<bool> sign_vector (n);
+  for ( int i = 0; i < n; ++i ) {
+    const auto& u = segments[i].first;
+    int r = 0;
+    while ( u[r] == 0 ) {
+      ++r;
+    }
+    sign_vector[i] = ( 0 < u[r] );
+  }
+  return sign_vector;
+}
+
+/**
+ * @brief Store the vertex with the given sign vector in vertex
+ */
+template <typename Number_t, typename Segment_t>
+void vertex_of_sign_vector (const std::vector<Segment_t>& segments,
+                            const std::vector<bool>& sign_vector,
+                            std::vector<Number_t>& vertex)
+{
+  const int n = segments.size();
+  const int d = vertex.size();
+  for ( int j = 0; j < d; ++j ) {
+    vertex[j] = 0;
+  }
+  for ( int i = 0; i < n; ++i ) {
+    const auto& v = sign_vector[i] ? segments[i].first : segments[i].second;
+    for ( int j = 0; j < d; ++j ) {
+      vertex[j] += v[j];
+    }
+  }
+}
+
+/**
+ * @brief The vertices of the sum of the segments (see
+ *        merge_parallel_generators), by depth-first search in the dual
+ *        arrangement with the adjacency oracle
+ */
+template <typename Number_t, typename Adjacency_oracle_t, typename Segment_t>
+std::vector<std::vector<Number_t> >
+_zonotope_vertices_by_adjacency (const int d,
+                                 const std::vector<Segment_t>& _generators)
+{
+  using std::vector;
+
   //
   // Perform arrangement-based adjacency traversal
   // 
 
   const Adjacency_oracle_t is_adjacent (_generators);
   const Sign_flip_functor<Adjacency_oracle_t> flip (is_adjacent);
-  
-  const int n = _generators.size();
 
   // Identify an initial vertex and its sign vector
-  vector<bool> sign_vector(n);
-  vector<Number_t> current_vertex (d, Number_t(0));
-  vector<Number_t> random_point   (d, Number_t(1)); // TODO: Pick a "more random" point
+  vector<bool> sign_vector = initial_sign_vector(_generators);
+  vector<Number_t> current_vertex (d);
+  vertex_of_sign_vector(_generators, sign_vector, current_vertex);
 
-  // TODO: Handle the case when random_point lies on too many hyperplanes at once
-  for ( int i = 0; i < n; ++i ) {
-    sign_vector[i] = ( 0 < dot<Number_t>(_generators[i].first, random_point) );
-    for ( int j = 0; j < d; ++j ) {
-      if (sign_vector[i]) {
-        current_vertex[j] += _generators[i].first[j];
-      } else {
-        current_vertex[j] += _generators[i].second[j];
-      }
-    }
+  // enumerate the vertices, with packed sign vectors for up to 512
+  // segments
+  const int n = _generators.size();
+  if ( n <= 64 ) {
+    Packed_sign_vector<1> packed_sign_vector (sign_vector);
+    return zonotope_vertices_dfs<Number_t, Adjacency_oracle_t>
+        (current_vertex, packed_sign_vector, flip, is_adjacent);
+  }
+  if ( n <= 128 ) {
+    Packed_sign_vector<2> packed_sign_vector (sign_vector);
+    return zonotope_vertices_dfs<Number_t, Adjacency_oracle_t>
+        (current_vertex, packed_sign_vector, flip, is_adjacent);
+  }
+  if ( n <= 256 ) {
+    Packed_sign_vector<4> packed_sign_vector (sign_vector);
+    return zonotope_vertices_dfs<Number_t, Adjacency_oracle_t>
+        (current_vertex, packed_sign_vector, flip, is_adjacent);
+  }
+  if ( n <= 512 ) {
+    Packed_sign_vector<8> packed_sign_vector (sign_vector);
+    return zonotope_vertices_dfs<Number_t, Adjacency_oracle_t>
+        (current_vertex, packed_sign_vector, flip, is_adjacent);
   }
-
-  // enumerate the vertices
   return zonotope_vertices_dfs<Number_t, Adjacency_oracle_t>
       (current_vertex, sign_vector, flip, is_adjacent);
 }
 
+/**
+ * @brief The vertices of a zonotope by depth-first search in the dual
+ *        arrangement, in any dimension
+ *
+ * This is what zonotope_vertices does for d > 3.
+ */
+template <typename Number_t, typename Adjacency_oracle_t>
+std::vector<std::vector<Number_t> >
+zonotope_vertices_by_adjacency (const std::vector<std::vector<Number_t> >& generators)
+{
+  const int d = generators[0].size();
+  return _zonotope_vertices_by_adjacency<Number_t, Adjacency_oracle_t>
+      (d, merge_parallel_generators(generators));
+}
+
+template <typename Number_t, typename Adjacency_oracle_t, typename Segment_t>
+std::vector<std::vector<Number_t> >
+_zonotope_vertices (const int d,
+                    const std::vector<Segment_t>& segments,
+                    std::true_type)
+{
+  if ( d == 3 ) {
+    return spatial_zonotope_vertices<Number_t>(segments);
+  }
+  return _zonotope_vertices_by_adjacency<Number_t, Adjacency_oracle_t>(d, segments);
+}
+
+template <typename Number_t, typename Adjacency_oracle_t, typename Segment_t>
+std::vector<std::vector<Number_t> >
+_zonotope_vertices (const int d,
+                    const std::vector<Segment_t>& segments,
+                    std::false_type)
+{
+  return _zonotope_vertices_by_adjacency<Number_t, Adjacency_oracle_t>(d, segments);
+}
+
+/**
+ * @brief The vertices of a zonotope
+ *
+ * For d = 2, the vertices are listed in counterclockwise order (see
+ * zonogon_vertices), and for d = 3 and the integral number types, they
+ * are collected from the edges (see spatial_zonotope_vertices). Neither
+ * constructs the adjacency oracle. Otherwise, the vertices are found by
+ * zonotope_vertices_by_adjacency.
+ */
+template <typename Number_t, typename Adjacency_oracle_t >
+std::vector<std::vector<Number_t> >
+zonotope_vertices (const std::vector<std::vector<Number_t> >& generators)
+{
+  const int d = generators[0].size();
+
+  const auto _generators = merge_parallel_generators(generators);
+
+  if ( d == 2 ) {
+    return zonogon_vertices<Number_t>(_generators);
+  }
+  return _zonotope_vertices<Number_t, Adjacency_oracle_t>
+      (d, _generators, typename Is_integral_number<Number_t>::type());
+}
+
 } // namespace zonotope
 
 #endif // VERTEX_ENUM_HPP_
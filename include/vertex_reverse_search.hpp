@@ -0,0 +1,270 @@
+#ifndef VERTEX_REVERSE_SEARCH_HPP_
+#define VERTEX_REVERSE_SEARCH_HPP_
+
+/**
+ * Vertex enumeration in zonotopes with the reverse search of Avis and
+ * Fukuda (see reverse_search.hpp). Unlike zonotope_vertices_dfs, it
+ * stores neither the visited sign vectors nor the vertices: the
+ * traversal only keeps the current sign vector and neighbor counter,
+ * and the vertices are passed to an output functor as they are found.
+ */
+
+#include "reverse_search.hpp"
+#include "parallel_reverse_search.hpp"
+#include "vertex_enum.hpp"
+
+#include <cassert>
+#include <vector>
+
+namespace zonotope {
+
+/**
+ * @brief The adjacency oracle of reverse_search on sign vectors
+ *
+ * `operator()(s, neighbor_counter)` returns s with the sign
+ * neighbor_counter-1 flipped if that is a neighboring vertex, and the
+ * empty sign vector otherwise.
+ */
+template <typename Adjacency_oracle_t>
+struct Sign_vector_adjacency {
+  typedef typename Adjacency_oracle_t::Cell_t Cell_t;
+
+  const Adjacency_oracle_t& is_adjacent;
+  const Cell_t NONE;
+
+  Sign_vector_adjacency( const Adjacency_oracle_t& is_adjacent )
+    : is_adjacent(is_adjacent)
+    , NONE()
+    { }
+
+  Cell_t operator() (const Cell_t& sign_vector, const int neighbor_counter) const {
+    const int k = neighbor_counter - 1;
+    if ( ! is_adjacent(sign_vector, k) ) {
+      return NONE;
+    }
+    Cell_t neighbor = sign_vector;
+    neighbor[k] = ( ! neighbor[k] );
+    return neighbor;
+  }
+};
+
+/**
+ * @brief The local search of reverse_search on sign vectors
+ *
+ * Moves from a vertex to the neighbor across the first facet
+ * hyperplane that separates it from the root. Every vertex other than
+ * the root has such a neighbor, since the segment from the vertex to
+ * the root in the dual arrangement leaves the cell of the vertex
+ * through a facet.
+ */
+template <typename Adjacency_oracle_t>
+struct Sign_vector_local_search {
+  typedef typename Adjacency_oracle_t::Cell_t Cell_t;
+
+  const Adjacency_oracle_t& is_adjacent;
+  const Cell_t& root;
+
+  Sign_vector_local_search( const Adjacency_oracle_t& is_adjacent,
+                            const Cell_t& root )
+    : is_adjacent(is_adjacent)
+    , root(root)
+    { }
+
+  Cell_t operator() (const Cell_t& sign_vector) const {
+    const int n = sign_vector.size();
+    for ( int k = 0; k < n; ++k ) {
+      if ( sign_vector[k] != root[k] && is_adjacent(sign_vector, k) ) {
+        Cell_t parent = sign_vector;
+        parent[k] = root[k];
+        return parent;
+      }
+    }
+    // sign_vector is the root
+    return sign_vector;
+  }
+};
+
+/**
+ * @brief Converts the sign vectors to vertices for the user's output
+ *        functor
+ */
+template <typename Number_t,
+          typename Segment_t,
+          typename Output_functor>
+struct Sign_vector_vertex_output {
+  const std::vector<Segment_t>& segments;
+  Output_functor& output;
+  std::vector<Number_t> vertex;
+  long count;
+
+  Sign_vector_vertex_output( const std::vector<Segment_t>& segments,
+                             Output_functor& output,
+                             const int d )
+    : segments(segments)
+    , output(output)
+    , vertex(d)
+    , count(0)
+    { }
+
+  void operator() (const std::vector<bool>& sign_vector) {
+    vertex_of_sign_vector(segments, sign_vector, vertex);
+    output(vertex);
+    ++count;
+  }
+};
+
+/**
+ * @brief zonotope_vertices_reverse_search, with reverse_search_with_stack
+ *        if with_stack is true
+ */
+template <typename Number_t,
+          typename Adjacency_oracle_t,
+          typename Output_functor>
+long _zonotope_vertices_reverse_search (
+  const std::vector<std::vector<Number_t> >& generators,
+  Output_functor& output,
+  const bool with_stack )
+{
+  typedef typename Adjacency_oracle_t::Cell_t Cell_t;
+  typedef typename Adjacency_oracle_t::Segment_t Segment_t;
+  typedef Sign_vector_adjacency<Adjacency_oracle_t> Adjacency_t;
+  typedef Sign_vector_local_search<Adjacency_oracle_t> Local_search_t;
+  typedef Sign_vector_vertex_output<Number_t, Segment_t, Output_functor> Vertex_output_t;
+
+  const int d = generators[0].size();
+
+  const std::vector<Segment_t> segments = merge_parallel_generators(generators);
+  Vertex_output_t vertex_output (segments, output, d);
+  const Cell_t root = initial_sign_vector(segments);
+
+  if ( segments.empty() ) {
+    // the zonotope is a point
+    vertex_output(root);
+    return vertex_output.count;
+  }
+
+  const Adjacency_oracle_t is_adjacent (segments);
+  const Adjacency_t adjacency (is_adjacent);
+  const Local_search_t local_search (is_adjacent, root);
+
+  if ( with_stack ) {
+    reverse_search_with_stack<Adjacency_t, Local_search_t, Cell_t, Vertex_output_t>
+      ( adjacency, segments.size(), root, adjacency.NONE, local_search, vertex_output );
+  } else {
+    reverse_search<Adjacency_t, Local_search_t, Cell_t, Vertex_output_t>
+      ( adjacency, segments.size(), root, adjacency.NONE, local_search, vertex_output );
+  }
+
+  return vertex_output.count;
+}
+
+/**
+ * @brief Enumerate the vertices of a zonotope by reverse search
+ *
+ * Calls `output(v)` with a `const std::vector<Number_t>&` once for
+ * every vertex v of the zonotope. The working memory of the traversal
+ * itself is O(n+d), and does not grow with the number of vertices;
+ * the remaining memory is that of the adjacency oracle, which is O(n*d)
+ * for Zonotope_vertex_adjacency_oracle_CGAL and proportional to the
+ * number of facets for Zonotope_vertex_adjacency_oracle.
+ *
+ * The price is time: reverse search calls the adjacency oracle O(n^2)
+ * times per vertex in the worst case (for the local search of every
+ * neighbor), where zonotope_vertices_dfs calls it n times.
+ *
+ * @return The number of vertices
+ */
+template <typename Number_t,
+          typename Adjacency_oracle_t,
+          typename Output_functor>
+long zonotope_vertices_reverse_search (
+  const std::vector<std::vector<Number_t> >& generators,
+  Output_functor& output )
+{
+  return _zonotope_vertices_reverse_search<Number_t, Adjacency_oracle_t>
+    (generators, output, false);
+}
+
+/**
+ * @brief Same as zonotope_vertices_reverse_search, but with
+ *        reverse_search_with_stack
+ *
+ * Visits the vertices in the same order, with fewer oracle calls on
+ * backtracking. In exchange, the working memory is O(n^2) bits for the
+ * sign vectors on the path to the root (every step of the local search
+ * fixes one more sign) instead of O(n+d).
+ *
+ * @return The number of vertices
+ */
+template <typename Number_t,
+          typename Adjacency_oracle_t,
+          typename Output_functor>
+long zonotope_vertices_reverse_search_with_stack (
+  const std::vector<std::vector<Number_t> >& generators,
+  Output_functor& output )
+{
+  return _zonotope_vertices_reverse_search<Number_t, Adjacency_oracle_t>
+    (generators, output, true);
+}
+
+/**
+ * @brief Same as zonotope_vertices_reverse_search, but distributes the
+ *        search over outputs.size() threads with
+ *        parallel_reverse_search.
+ *
+ * Each thread passes its vertices to its own output functor,
+ * outputs[thread_index], so outputs must not be empty. If the zonotope
+ * is a point, its vertex is passed to outputs[0]. A single adjacency
+ * oracle is shared by all threads, so its queries must be thread-safe
+ * (as they are for both oracles in this library).
+ *
+ * @return The number of vertices
+ */
+template <typename Number_t,
+          typename Adjacency_oracle_t,
+          typename Output_functor>
+long zonotope_vertices_reverse_search_parallel (
+  const std::vector<std::vector<Number_t> >& generators,
+  std::vector<Output_functor>& outputs,
+  const long budget = 1000 )
+{
+  typedef typename Adjacency_oracle_t::Cell_t Cell_t;
+  typedef typename Adjacency_oracle_t::Segment_t Segment_t;
+  typedef Sign_vector_adjacency<Adjacency_oracle_t> Adjacency_t;
+  typedef Sign_vector_local_search<Adjacency_oracle_t> Local_search_t;
+  typedef Sign_vector_vertex_output<Number_t, Segment_t, Output_functor> Vertex_output_t;
+
+  assert( ! outputs.empty() );
+
+  const int d = generators[0].size();
+
+  const std::vector<Segment_t> segments = merge_parallel_generators(generators);
+  std::vector<Vertex_output_t> vertex_outputs;
+  for ( Output_functor& output : outputs ) {
+    vertex_outputs.push_back( Vertex_output_t(segments, output, d) );
+  }
+  const Cell_t root = initial_sign_vector(segments);
+
+  if ( segments.empty() ) {
+    // the zonotope is a point
+    vertex_outputs[0](root);
+    return 1;
+  }
+
+  const Adjacency_oracle_t is_adjacent (segments);
+  const Adjacency_t adjacency (is_adjacent);
+  const Local_search_t local_search (is_adjacent, root);
+
+  parallel_reverse_search<Adjacency_t, Local_search_t, Cell_t, Vertex_output_t>
+    ( adjacency, segments.size(), root, adjacency.NONE, local_search, vertex_outputs, budget );
+
+  long count = 0;
+  for ( const Vertex_output_t& vertex_output : vertex_outputs ) {
+    count += vertex_output.count;
+  }
+  return count;
+}
+
+} // namespace zonotope
+
+#endif // VERTEX_REVERSE_SEARCH_HPP_
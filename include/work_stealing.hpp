@@ -0,0 +1,116 @@
+#ifndef WORK_STEALING_HPP_
+#define WORK_STEALING_HPP_
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace zonotope {
+
+/**
+ * @brief The number of worker threads to use when the user does not
+ *        ask for a specific number.
+ */
+inline int default_num_threads() {
+  const int num_threads = std::thread::hardware_concurrency();
+  return ( num_threads > 0 ) ? num_threads : 1;
+}
+
+/**
+ * @brief One task queue per worker thread, where idle workers steal
+ *        from the back of the other queues.
+ *
+ * The owner of a queue pops tasks from the front, while thieves take
+ * tasks from the back, so that the owner and the thieves rarely touch
+ * the same end of a queue.
+ */
+struct Work_stealing_queues {
+
+  struct Queue {
+    std::mutex lock;
+    std::deque<int> tasks;
+  };
+
+  std::vector<Queue> queues;
+
+  /**
+   * @brief Distribute the tasks 0..(num_tasks-1) round-robin over
+   *        num_threads queues.
+   */
+  Work_stealing_queues( const int num_tasks, const int num_threads )
+    : queues( num_threads )
+  {
+    for ( int task = 0; task < num_tasks; ++task ) {
+      queues[task % num_threads].tasks.push_back(task);
+    }
+  }
+
+  /**
+   * @brief Fetch the next task for the worker `thread_index`.
+   *
+   * @return true iff a task was found, in which case it is stored in
+   *         task. Once this returns false for some worker, all tasks
+   *         have been handed out.
+   */
+  bool pop( const int thread_index, int& task ) {
+    const int num_threads = queues.size();
+    {
+      Queue& own = queues[thread_index];
+      std::lock_guard<std::mutex> guard ( own.lock );
+      if ( ! own.tasks.empty() ) {
+        task = own.tasks.front();
+        own.tasks.pop_front();
+        return true;
+      }
+    }
+    // the own queue is empty, so we try to steal from the others
+    for ( int offset = 1; offset < num_threads; ++offset ) {
+      Queue& victim = queues[(thread_index + offset) % num_threads];
+      std::lock_guard<std::mutex> guard ( victim.lock );
+      if ( ! victim.tasks.empty() ) {
+        task = victim.tasks.back();
+        victim.tasks.pop_back();
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+/**
+ * @brief Run `fn(task, thread_index)` for every task in
+ *        0..(num_tasks-1) on num_threads work-stealing workers.
+ *
+ * The calling thread acts as worker 0, so that num_threads == 1 runs
+ * all the tasks sequentially without spawning any threads. The
+ * functor is shared by all workers, and must only modify state that
+ * is private to thread_index.
+ */
+template <typename Task_functor>
+void parallel_for_each_task( const int num_tasks,
+                             const int num_threads,
+                             Task_functor& fn )
+{
+  Work_stealing_queues queues ( num_tasks, num_threads );
+
+  auto worker = [&queues, &fn] ( const int thread_index ) {
+    int task;
+    while ( queues.pop(thread_index, task) ) {
+      fn(task, thread_index);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for ( int t = 1; t < num_threads; ++t ) {
+    threads.push_back( std::thread(worker, t) );
+  }
+  worker(0);
+  for ( std::thread& thread : threads ) {
+    thread.join();
+  }
+}
+
+} // namespace zonotope
+
+#endif // WORK_STEALING_HPP_
@@ -0,0 +1,151 @@
+#ifndef ZONOTOPE_HPP_
+#define ZONOTOPE_HPP_
+
+#include "combination_traversal.hpp"
+#include "zonotope_volume.hpp"
+#include "zonotope_volume_output_functor.hpp"
+#include "preprocess_generators.hpp"
+#include "type_casting_functor.hpp"
+#include "linalg.hpp"
+#include "matrix.hpp"
+
+#include <vector>
+#include <gmpxx.h>
+
+namespace zonotope {
+
+/**
+ * @brief A zonotope whose generators can be added and removed, and
+ *        which keeps its volume up to date.
+ *
+ * The volume is the sum of |det| over the d-subsets of the generators,
+ * so adding a generator g adds the sum of |det(S, g)| over the
+ * (d-1)-subsets S of the other generators, and removing it subtracts
+ * the same sum. An update therefore traverses O(C(n,d-1)) combinations
+ * instead of the O(C(n,d)) of zonotope_volume: the generator g is put
+ * in front of the others, and the traversal starts from the
+ * combination {g}.
+ *
+ * The number types have the same meaning as in zonotope_volume. With
+ * a user type like mpq_class or double, the generators are scaled
+ * separately for every update, so the volume is exact for mpq_class
+ * and accumulates rounding errors for double.
+ */
+template <typename User_number_t = mpz_class,
+          typename Internal_number_t = mpz_class>
+class Zonotope {
+public:
+  typedef std::vector<User_number_t> Vector_t;
+  typedef typename Volume_combination_container<Internal_number_t>::type Combination_container_t;
+  typedef Zonotope_volume_output_functor<Internal_number_t, Combination_container_t> Output_functor_t;
+
+  /**
+   * @brief The zonotope with no generators (a point) in dimension d
+   */
+  Zonotope( const int d )
+    : d_(d)
+    , volume_(0)
+    { }
+
+  Zonotope( const std::vector<Vector_t>& generators )
+    : d_(generators[0].size())
+    , generators_(generators)
+    , volume_(0)
+  {
+    if ( int(generators_.size()) >= d_ ) {
+      volume_ = zonotope_volume<User_number_t, Internal_number_t>(generators_);
+    }
+  }
+
+  int dimension() const {
+    return d_;
+  }
+
+  int num_generators() const {
+    return generators_.size();
+  }
+
+  const std::vector<Vector_t>& generators() const {
+    return generators_;
+  }
+
+  const User_number_t& volume() const {
+    return volume_;
+  }
+
+  /**
+   * @brief Add the generator g, and update the volume in
+   *        O(C(n,d-1)) determinant updates
+   */
+  void add_generator( const Vector_t& g ) {
+    volume_ += volume_change(g, -1);
+    generators_.push_back(g);
+  }
+
+  /**
+   * @brief Remove generator i (the others keep their order), and update
+   *        the volume in O(C(n,d-1)) determinant updates
+   */
+  void remove_generator( const int i ) {
+    volume_ -= volume_change(generators_[i], i);
+    generators_.erase(generators_.begin() + i);
+  }
+
+private:
+
+  /**
+   * @brief The sum of |det(S, g)| over the (d-1)-subsets S of the
+   *        generators other than generator `skip`
+   */
+  User_number_t volume_change( const Vector_t& g, const int skip ) {
+    const int n = generators_.size();
+    const int n_others = ( skip < 0 ) ? n : n - 1;
+    if ( n_others < d_ - 1 ) {
+      return User_number_t(0);
+    }
+
+    // g goes first, so that the traversal can start from {g}; the
+    // input rows are reused from update to update
+    update_input_.resize(n_others + 1);
+    update_input_[0] = g;
+    int row = 1;
+    for ( int k = 0; k < n; ++k ) {
+      if ( k != skip ) {
+        update_input_[row++] = generators_[k];
+      }
+    }
+    preprocess_generators(update_input_, internal_generators_, scaling_factor_);
+
+    Combination_container_t combination (internal_generators_, d_);
+    combination.extend(0);
+    if ( ! combination.is_valid() ) {
+      // g = 0
+      return User_number_t(0);
+    }
+    Output_functor_t output (internal_generators_);
+    traverse_combinations_in_place<Combination_container_t, Output_functor_t>
+      (combination, output);
+
+    User_number_t change = Cast_to_user_type(output.volume);
+    scaling_factor_ = _pow<Internal_number_t> (scaling_factor_, d_);
+    change /= Cast_to_user_type(scaling_factor_);
+    return change;
+  }
+
+  Type_casting_functor<Internal_number_t, User_number_t> Cast_to_user_type;
+
+  int d_;
+  std::vector<Vector_t> generators_;
+  User_number_t volume_;
+
+  /**
+   * Scratch space for volume_change
+   */
+  std::vector<Vector_t> update_input_;
+  Matrix<Internal_number_t> internal_generators_;
+  Internal_number_t scaling_factor_;
+};
+
+} // namespace zonotope
+
+#endif // ZONOTOPE_HPP_
@@ -0,0 +1,131 @@
+#ifndef ZONOTOPE_F_VECTOR_HPP_
+#define ZONOTOPE_F_VECTOR_HPP_
+
+#include "combination_traversal.hpp"
+#include "parallel_combination_traversal.hpp"
+#include "combination_kernel_stack.hpp"
+#include "zonotope_face_output_functor.hpp"
+#include "preprocess_generators.hpp"
+
+// External dependencies
+#include <vector>
+#include <gmpxx.h>
+
+namespace zonotope {
+
+/**
+ * @brief Stream the translation classes of the faces of a zonotope to
+ *        a sink, by increasing dimension.
+ *
+ * Calls `sink(c)` with a `const Zonotope_face_class&` for every flat of
+ * the generators, exactly once per flat, from the vertices (the flat
+ * of the zero generators) up to the zonotope itself. Neither the faces
+ * nor the flats are stored in between.
+ *
+ * The faces of every dimension are found by a traversal of the
+ * independent combinations of that size (see
+ * Zonotope_face_output_functor), so that the cost of a dimension is
+ * about that of the halfspace construction (see zonotope_halfspaces)
+ * for each of its flats.
+ *
+ * @return The number of face classes passed to the sink
+ */
+template <typename User_number_t,
+          typename Internal_number_t = mpz_class,
+          typename Face_class_sink_t>
+long zonotope_face_classes_stream (
+  const std::vector<std::vector<User_number_t> >& generators_in,
+  Face_class_sink_t& sink )
+{
+  typedef Combination_kernel_stack<Internal_number_t> Combination_container_t;
+  typedef Zonotope_face_output_functor<Internal_number_t,
+                                       Combination_container_t,
+                                       Face_class_sink_t>
+      Traversal_output_functor_t;
+
+  const int d = generators_in[0].size();
+
+  Matrix<Internal_number_t> internal_generators;
+  preprocess_generators<User_number_t, Internal_number_t> (generators_in,
+                                                           internal_generators);
+
+  long num_face_classes = 0;
+  for ( int k = 0; k <= d; ++k ) {
+    Combination_container_t empty_combination (internal_generators, k);
+    Traversal_output_functor_t Traversal_output_fn (internal_generators, k, &sink);
+    traverse_combinations_in_place<Combination_container_t, Traversal_output_functor_t>
+      (empty_combination, Traversal_output_fn);
+    num_face_classes += Traversal_output_fn.num_face_classes;
+  }
+  return num_face_classes;
+}
+
+/**
+ * @brief The f-vector of a zonotope
+ *
+ * Only counts the faces (see zonotope_face_classes_stream). The
+ * combinations of every size are distributed over the workers as in
+ * zonotope_halfspaces_parallel.
+ *
+ * @param num_threads The number of worker threads, or 0 to use one
+ *                    per hardware thread.
+ *
+ * @return The vector f of size d+1, where f[k] is the number of
+ *         k-faces. For generators of rank r < d, the entries after
+ *         f[r] = 1 are zero.
+ */
+template <typename User_number_t,
+          typename Internal_number_t = mpz_class>
+std::vector<long> zonotope_f_vector (
+  const std::vector<std::vector<User_number_t> >& generators_in,
+  int num_threads = 1 )
+{
+  struct No_sink {
+    void operator() (const Zonotope_face_class&) {}
+  };
+
+  typedef Combination_kernel_stack<Internal_number_t> Combination_container_t;
+  typedef Zonotope_face_output_functor<Internal_number_t,
+                                       Combination_container_t,
+                                       No_sink>
+      Traversal_output_functor_t;
+
+  const int d = generators_in[0].size();
+
+  if ( num_threads <= 0 ) {
+    num_threads = default_num_threads();
+  }
+
+  // merging parallel generators translates the zonotope, which keeps
+  // its f-vector
+  Matrix<Internal_number_t> internal_generators;
+  preprocess_generators<User_number_t, Internal_number_t> (generators_in,
+                                                           internal_generators);
+  std::vector<Internal_number_t> translation;
+  merge_parallel_generators_in_place(internal_generators, translation);
+  const int n = internal_generators.rows();
+
+  std::vector<long> f_vector (d + 1, 0);
+  for ( int k = 0; k <= d; ++k ) {
+    Combination_container_t empty_combination (internal_generators, k);
+    std::vector<Traversal_output_functor_t> traversal_output_fns
+      (num_threads, Traversal_output_functor_t(internal_generators, k));
+
+    if ( num_threads == 1 ) {
+      traverse_combinations_in_place<Combination_container_t, Traversal_output_functor_t>
+        (empty_combination, traversal_output_fns[0]);
+    } else {
+      traverse_combinations_parallel<Combination_container_t, Traversal_output_functor_t>
+        (empty_combination, traversal_output_fns, default_split_depth(n, k, num_threads));
+    }
+
+    for ( const Traversal_output_functor_t& output_fn : traversal_output_fns ) {
+      f_vector[k] += output_fn.num_faces;
+    }
+  }
+  return f_vector;
+}
+
+} // namespace zonotope
+
+#endif // ZONOTOPE_F_VECTOR_HPP_
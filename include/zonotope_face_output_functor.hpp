@@ -0,0 +1,236 @@
+#ifndef ZONOTOPE_FACE_OUTPUT_FUNCTOR_HPP_
+#define ZONOTOPE_FACE_OUTPUT_FUNCTOR_HPP_
+
+#include "combination_kernel_stack.hpp"
+#include "event_point_2.hpp"
+#include "output_functor_base.hpp"
+
+#include <vector>
+
+namespace zonotope {
+
+/**
+ * @brief The k-faces of a zonotope that are translates of each other
+ *
+ * Every k-face of the zonotope is a translate of the zonotope of the
+ * generators in some flat of rank k (the generators parallel to the
+ * face), and the faces with the same flat are its translation class.
+ */
+struct Zonotope_face_class {
+  /**
+   * The dimension of the faces, i.e. the rank of the flat
+   */
+  int dimension;
+
+  /**
+   * The indices of the generators in the flat, in increasing order
+   */
+  std::vector<int> generators;
+
+  /**
+   * The number of faces in the class
+   */
+  long num_faces;
+};
+
+/**
+ * @brief Counts the faces of a given dimension, for the traversal of
+ *        the independent combinations.
+ *
+ * A combination S of size `dimension` stands for the flat F it spans
+ * iff it is the lexicographically first basis of F (the one the greedy
+ * algorithm picks), which is tested the same way as in
+ * handle_event_points. The combinations that fail the test are leaves,
+ * since none of their extensions pass it either.
+ *
+ * The k-faces with flat F correspond to the regions of the central
+ * arrangement of the generators outside F, projected along F, and by
+ * Zaslavsky's theorem these are counted by the no-broken-circuit
+ * (NBC) sets of that arrangement. A set T = {t_1 < ... < t_j} is NBC
+ * iff every t_i is the smallest generator outside F in the span of
+ * F and t_i, ..., t_j, so the NBC sets are traversed by adding
+ * elements in decreasing order. Once the span of F and T has rank d-2,
+ * the NBC sets that extend T are counted directly in the plane of its
+ * kernel: if the smaller generators project to p distinct lines, there
+ * are 1 + p + (p-1) = 2p of them. As in handle_event_points, the lines
+ * are counted by sorting the projections by angle.
+ *
+ * If `sink` is set, it is passed the Zonotope_face_class of every flat.
+ */
+template <typename NT,
+          typename Combination_container,
+          typename Face_class_sink>
+struct Zonotope_face_output_functor : Output_functor_base<NT>
+{
+  using typename Output_functor_base<NT>::Generator_container_t;
+
+  /**
+   * The dimension of the faces to count
+   */
+  int dimension;
+
+  Face_class_sink* sink;
+
+  /**
+   * The number of faces and face classes found so far
+   */
+  long num_faces;
+  long num_face_classes;
+
+  /**
+   * Spans a flat and then the NBC sets of its quotient
+   */
+  Combination_kernel_stack<NT> quotient;
+
+  /**
+   * Reused by every planar count
+   */
+  Event_point_buffer<NT> event_buffer;
+
+  Zonotope_face_output_functor (
+    const Generator_container_t& generators,
+    const int dimension,
+    Face_class_sink* sink = nullptr )
+    : Output_functor_base<NT>(generators)
+    , dimension(dimension)
+    , sink(sink)
+    , num_faces(0)
+    , num_face_classes(0)
+    , quotient(generators, generators.cols())
+    , event_buffer(generators)
+  {}
+
+  bool operator() (const Combination_container& combination) {
+    const int k = combination.size();
+    if ( k > 0 && ! is_first_basis(combination) ) {
+      return true;
+    }
+    if ( k < dimension ) {
+      return false;
+    }
+
+    while ( quotient.size() > 0 ) {
+      quotient.retract();
+    }
+    for ( const int i : combination.elements ) {
+      quotient.extend(i);
+    }
+    const long num_class_faces = count_regions(this->n);
+    num_faces += num_class_faces;
+    ++num_face_classes;
+
+    if ( sink ) {
+      Zonotope_face_class face_class { dimension, std::vector<int>(), num_class_faces };
+      for ( int j = 0; j < this->n; ++j ) {
+        if ( combination.prefix_spans(k, this->generators[j]) ) {
+          face_class.generators.push_back(j);
+        }
+      }
+      (*sink)(face_class);
+    }
+    return true;
+  }
+
+private:
+
+  /**
+   * @brief true iff the combination is the first basis of its span,
+   *        given that the combination without its last element is.
+   *
+   * That fails iff some generator j < back() outside the combination
+   * is in the span of the combination, but not of its prefix.
+   */
+  bool is_first_basis (const Combination_container& combination) const {
+    const int k = combination.size();
+    for ( int j = 0; j < combination.back(); ++j ) {
+      if ( combination.prefix_spans(k, this->generators[j]) &&
+           ! combination.prefix_spans(k-1, this->generators[j]) ) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief The number of NBC sets that extend the current set T of the
+   *        quotient with generators smaller than `bound` (the smallest
+   *        element of T)
+   */
+  long count_regions (const int bound) {
+    const int k = quotient.size();
+    const int kernel_size = quotient.kernel_size();
+
+    if ( kernel_size <= 2 ) {
+      const long num_lines = count_lines(bound);
+      return ( num_lines > 0 ) ? 2 * num_lines : 1;
+    }
+
+    long count = 1;
+    for ( int s = 0; s < bound; ++s ) {
+      if ( quotient.prefix_spans(k, this->generators[s]) ) {
+        // s is in F, or in the span of F and T
+        continue;
+      }
+      quotient.extend(s);
+      bool is_nbc = true;
+      for ( int j = 0; j < s && is_nbc; ++j ) {
+        is_nbc = ! ( quotient.prefix_spans(k+1, this->generators[j]) &&
+                     ! quotient.prefix_spans(k, this->generators[j]) );
+      }
+      if ( is_nbc ) {
+        count += count_regions(s);
+      }
+      quotient.retract();
+    }
+    return count;
+  }
+
+  /**
+   * @brief The number of distinct lines that the generators smaller
+   *        than `bound` project to, in the kernel of the current
+   *        combination (of dimension at most 2), not counting the
+   *        origin
+   */
+  long count_lines (const int bound) {
+    const int kernel_size = quotient.kernel_size();
+    if ( kernel_size == 0 ) {
+      return 0;
+    }
+    if ( kernel_size == 1 ) {
+      for ( int j = 0; j < bound; ++j ) {
+        if ( dot<NT>(quotient.kernel_row(0), this->generators[j]) != 0 ) {
+          return 1;
+        }
+      }
+      return 0;
+    }
+
+    std::vector<NT>& x = event_buffer.x;
+    std::vector<NT>& y = event_buffer.y;
+    std::vector<int>& events = event_buffer.events;
+    event_buffer.projection( quotient.kernel_row(0), quotient.kernel_row(1), x, y );
+
+    events.clear();
+    for ( int j = 0; j < bound; ++j ) {
+      if ( y[j] < 0 || ( y[j] == 0 && x[j] < 0 ) ) {
+        events.push_back( 2*j + 1 );
+      } else if ( x[j] != 0 || y[j] != 0 ) {
+        events.push_back( 2*j );
+      }
+    }
+    event_buffer.angular_sort( x, y, events );
+
+    long num_lines = 0;
+    const int num_events = events.size();
+    for ( int position = 0; position < num_events; ++position ) {
+      if ( event_buffer.angular_sort.starts_angle(position) ) {
+        ++num_lines;
+      }
+    }
+    return num_lines;
+  }
+};
+
+} // namespace zonotope
+
+#endif // ZONOTOPE_FACE_OUTPUT_FUNCTOR_HPP_
@@ -2,18 +2,140 @@
 #define ZONOTOPE_HALFSPACES_HPP_
 
 #include "combination_traversal.hpp"
+#include "parallel_combination_traversal.hpp"
 #include "hyperplane.hpp"
 #include "zonotope_halfspaces_output_functor.hpp"
-#include "combination_kernel_container.hpp"
+#include "combination_kernel_stack.hpp"
 #include "preprocess_generators.hpp"
+#include "fixed_dimension.hpp"
+#include "low_dimensional_zonotopes.hpp"
 
 // External dependencies
 #include <vector>
 #include <set>
+#include <algorithm>
 #include <gmpxx.h>
 
 namespace zonotope {
 
+/**
+ * @brief Passes the halfspaces of the merged generators to output_fn,
+ *        moved by the translation of merge_parallel_generators_in_place
+ *        (which is empty if nothing was merged).
+ */
+template <typename Number_t,
+          typename Halfspaces_output_functor_t>
+struct Translated_halfspaces_output_functor {
+
+  const std::vector<Number_t>& translation;
+  Halfspaces_output_functor_t& output_fn;
+
+  /**
+   * Reused for every halfspace
+   */
+  Hyperplane<Number_t> translated;
+
+  Translated_halfspaces_output_functor (
+    const std::vector<Number_t>& translation,
+    Halfspaces_output_functor_t& output_fn )
+    : translation( translation )
+    , output_fn( output_fn )
+    , translated( translation.size() )
+  {}
+
+  void operator() (const Hyperplane<Number_t>& h) {
+    if ( translation.empty() ) {
+      output_fn(h);
+      return;
+    }
+    translated.normal = h.normal;
+    translated.offset = h.offset;
+    translated.offset -= dot<Number_t>(h.normal, translation);
+    output_fn(translated);
+  }
+};
+
+/**
+ * @brief The traversal of zonotope_halfspaces_traversal over the
+ *        merged generators, with the kernel stack for the dimension D
+ *        (see dispatch_dimension)
+ */
+template <typename Internal_number_t,
+          typename Halfspaces_output_functor_t>
+struct _Zonotope_halfspaces_traversal {
+  typedef void result_type;
+
+  const Matrix<Internal_number_t>& generators;
+  Halfspaces_output_functor_t& output_fn;
+
+  template <int D>
+  void run() {
+    typedef Combination_kernel_stack<Internal_number_t, D> Combination_container_t;
+
+    typedef Zonotope_halfspaces_output_functor<Internal_number_t,
+                                               Combination_container_t,
+                                               Halfspaces_output_functor_t>
+        Traversal_output_functor_t;
+
+    const int d = generators.cols();
+
+    Combination_container_t empty_combination (generators, d-1);
+
+    Traversal_output_functor_t Traversal_output_fn (generators, output_fn);
+
+    traverse_combinations_in_place<Combination_container_t, Traversal_output_functor_t>
+      (empty_combination, Traversal_output_fn);
+    // we only traverse up to (d-2)-combinations because after that,
+    // Traversal_output_fn takes over and traverses the (d-1)-child-combinations
+    // in a manner specific to the halfspace traversal.
+  }
+};
+
+/**
+ * @brief Pass every halfspace (in terms of the internal generators) to
+ *        output_fn.
+ *
+ * Every facet is passed exactly once (see handle_event_points). The
+ * parallel generators are merged first (see
+ * merge_parallel_generators_in_place), so that the traversal only runs
+ * over the combinations of the classes of parallel generators. For
+ * small d, the kernel stack is instantiated for the dimension (see
+ * dispatch_dimension). For d = 2, neither is needed (see
+ * zonogon_halfspaces_traversal).
+ */
+template <typename User_number_t,
+          typename Internal_number_t,
+          typename Halfspaces_output_functor_t>
+void zonotope_halfspaces_traversal (
+  const std::vector<std::vector<User_number_t> >& generators_in,
+  Halfspaces_output_functor_t& output_fn )
+{
+  typedef Translated_halfspaces_output_functor<Internal_number_t,
+                                               Halfspaces_output_functor_t>
+      Translated_output_functor_t;
+
+  const int d = generators_in[0].size();
+
+  Matrix<Internal_number_t> internal_generators;
+
+  preprocess_generators<User_number_t, Internal_number_t> (generators_in,
+                                                           internal_generators);
+
+  if ( d == 2 ) {
+    zonogon_halfspaces_traversal(internal_generators, output_fn);
+    return;
+  }
+
+  std::vector<Internal_number_t> translation;
+  merge_parallel_generators_in_place(internal_generators, translation);
+
+  Translated_output_functor_t Translated_output_fn (translation, output_fn);
+
+  _Zonotope_halfspaces_traversal<Internal_number_t, Translated_output_functor_t>
+    traversal { internal_generators, Translated_output_fn };
+  dispatch_dimension(d, traversal);
+}
+
 /**
  * @brief Generic construction of the set of halfspaces
  *
@@ -25,8 +147,6 @@ void zonotope_halfspaces (
   const std::vector<std::vector<User_number_t> >& generators_in,
   Halfspaces_container_t& halfspaces )
 {
-  typedef Combination_kernel_container<Internal_number_t> Combination_container_t;
-
   typedef Container_output_functor<Halfspaces_container_t,
                                    Hyperplane<Internal_number_t>,
                                    Hyperplane<User_number_t> >
@@ -34,28 +154,154 @@ void zonotope_halfspaces (
 
   Container_output_functor_t Halfspaces_container_output_fn ( halfspaces );
 
+  zonotope_halfspaces_traversal<User_number_t, Internal_number_t>
+    (generators_in, Halfspaces_container_output_fn);
+}
+
+/**
+ * @brief Stream the halfspaces to a sink as they are constructed
+ *
+ * Calls `sink(h)` with a `const Hyperplane<User_number_t>&` for every
+ * facet of the zonotope, exactly once per facet, and in no particular
+ * order. Nothing is stored in between, so the memory use does not
+ * depend on the number of facets.
+ *
+ * @return The number of halfspaces passed to the sink
+ */
+template <typename User_number_t,
+          typename Internal_number_t = mpz_class,
+          typename Halfspace_sink_t>
+long zonotope_halfspaces_stream (
+  const std::vector<std::vector<User_number_t> >& generators_in,
+  Halfspace_sink_t& sink )
+{
+  typedef Sink_output_functor<Halfspace_sink_t,
+                              Hyperplane<Internal_number_t>,
+                              Hyperplane<User_number_t> >
+      Sink_output_functor_t;
+
+  Sink_output_functor_t Sink_output_fn ( sink );
+
+  zonotope_halfspaces_traversal<User_number_t, Internal_number_t>
+    (generators_in, Sink_output_fn);
+
+  return Sink_output_fn.count;
+}
+
+/**
+ * @brief Same as zonotope_halfspaces, but distributes the
+ *        (d-2)-combinations over several threads.
+ *
+ * Each worker writes its halfspaces to a thread-local buffer, and the
+ * buffers are merged into halfspaces once all workers are done, using
+ * `halfspaces.insert(halfspaces.end(), h)`, so both sets and sequence
+ * containers can be used for the output.
+ *
+ * @param num_threads The number of worker threads, or 0 to use one
+ *                    per hardware thread.
+ *
+ * @param deterministic If true, the merged halfspaces are sorted and
+ *                      deduplicated before they are inserted, so the
+ *                      insertion order does not depend on the
+ *                      scheduling of the workers. Otherwise the buffers
+ *                      are inserted in worker order, and uniqueness
+ *                      relies on handle_event_points (every facet is
+ *                      constructed exactly once).
+ *
+ * @param split_depth The size of the prefix combinations that are
+ *                    distributed among the workers, or 0 to choose
+ *                    one from n, d and num_threads.
+ */
+template <typename User_number_t,
+          typename Internal_number_t = mpz_class,
+          typename Halfspaces_container_t = std::set<Hyperplane<User_number_t> > >
+void zonotope_halfspaces_parallel (
+  const std::vector<std::vector<User_number_t> >& generators_in,
+  Halfspaces_container_t& halfspaces,
+  int num_threads = 0,
+  const bool deterministic = false,
+  int split_depth = 0 )
+{
+  typedef Combination_kernel_stack<Internal_number_t> Combination_container_t;
+
+  typedef std::vector<Hyperplane<User_number_t> > Buffer_t;
+
+  typedef Sequence_output_functor<Buffer_t,
+                                  Hyperplane<Internal_number_t>,
+                                  Hyperplane<User_number_t> >
+      Buffer_output_functor_t;
+
+  typedef Translated_halfspaces_output_functor<Internal_number_t,
+                                               Buffer_output_functor_t>
+      Translated_output_functor_t;
+
   typedef Zonotope_halfspaces_output_functor<Internal_number_t,
                                              Combination_container_t,
-                                             Container_output_functor_t>
+                                             Translated_output_functor_t>
       Traversal_output_functor_t;
 
   const int d = generators_in[0].size();
 
-  std::vector<std::vector<Internal_number_t> > internal_generators;
+  Matrix<Internal_number_t> internal_generators;
 
   preprocess_generators<User_number_t, Internal_number_t> (generators_in,
                                                            internal_generators);
 
+  std::vector<Internal_number_t> translation;
+  merge_parallel_generators_in_place(internal_generators, translation);
+  const int n = internal_generators.rows();
+
+  if ( num_threads <= 0 ) {
+    num_threads = default_num_threads();
+  }
+  if ( split_depth <= 0 ) {
+    split_depth = default_split_depth(n, d-1, num_threads);
+  }
+
+  // one buffer, sink and traversal functor per worker
+  std::vector<Buffer_t> buffers (num_threads);
+  std::vector<Buffer_output_functor_t> buffer_output_fns;
+  std::vector<Translated_output_functor_t> translated_output_fns;
+  std::vector<Traversal_output_functor_t> traversal_output_fns;
+  buffer_output_fns.reserve(num_threads);
+  translated_output_fns.reserve(num_threads);
+  traversal_output_fns.reserve(num_threads);
+  for ( int t = 0; t < num_threads; ++t ) {
+    buffer_output_fns.push_back( Buffer_output_functor_t(buffers[t]) );
+  }
+  for ( int t = 0; t < num_threads; ++t ) {
+    translated_output_fns.push_back(
+      Translated_output_functor_t(translation, buffer_output_fns[t]) );
+  }
+  for ( int t = 0; t < num_threads; ++t ) {
+    traversal_output_fns.push_back(
+      Traversal_output_functor_t(internal_generators, translated_output_fns[t]) );
+  }
+
   Combination_container_t empty_combination (internal_generators, d-1);
 
-  Traversal_output_functor_t Traversal_output_fn (internal_generators,
-                                                  Halfspaces_container_output_fn);
+  traverse_combinations_parallel<Combination_container_t, Traversal_output_functor_t>
+    (empty_combination, traversal_output_fns, split_depth);
 
-  traverse_combinations<Combination_container_t, Traversal_output_functor_t>
-    (empty_combination, Traversal_output_fn);
-  // we only traverse up to (d-2)-combinations because after that,
-  // Traversal_output_fn takes over and traverses the (d-1)-child-combinations
-  // in a manner specific to the halfspace traversal.
+  // merge the thread-local buffers
+  if ( deterministic ) {
+    Buffer_t merged;
+    for ( Buffer_t& buffer : buffers ) {
+      merged.insert(merged.end(), buffer.begin(), buffer.end());
+      Buffer_t().swap(buffer);
+    }
+    std::sort(merged.begin(), merged.end());
+    merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+    for ( const Hyperplane<User_number_t>& h : merged ) {
+      halfspaces.insert(halfspaces.end(), h);
+    }
+  } else {
+    for ( const Buffer_t& buffer : buffers ) {
+      for ( const Hyperplane<User_number_t>& h : buffer ) {
+        halfspaces.insert(halfspaces.end(), h);
+      }
+    }
+  }
 }
 
 } // namespace zonotope
@@ -0,0 +1,209 @@
+#ifndef ZONOTOPE_HALFSPACES_INCREMENTAL_HPP_
+#define ZONOTOPE_HALFSPACES_INCREMENTAL_HPP_
+
+#include "zonotope_halfspaces.hpp"
+#include "zonotope_halfspaces_output_functor.hpp"
+#include "combination_kernel_stack.hpp"
+#include "combination_traversal.hpp"
+#include "preprocess_generators.hpp"
+#include "type_casting_functor.hpp"
+#include "hyperplane.hpp"
+#include "linalg.hpp"
+#include "matrix.hpp"
+
+#include <map>
+#include <vector>
+#include <gmpxx.h>
+
+namespace zonotope {
+
+/**
+ * @brief The halfspaces of a zonotope, kept up to date as generators
+ *        are added.
+ *
+ * The facet normals of a zonotope are the normals of the hyperplanes
+ * spanned by d-1 of its generators. Adding a generator g therefore
+ * keeps every facet normal. The support function grows by
+ * max(0, dot(u, g)) in direction u, so the offset of the facet with
+ * normal c grows by -min(0, dot(c, g)). Facets parallel to g keep
+ * their offset. The only new facets are the hyperplanes spanned by g
+ * and d-2 of the old generators.
+ *
+ * add_generator updates the offsets in one pass over the facets. For
+ * the new facets, it puts g in front of the internal generators and
+ * traverses only the combinations that start with g. A facet is output
+ * for the lexicographically first basis of its generators (see
+ * handle_event_points), and that basis starts with g iff the facet
+ * contains g. So the traversal finds each facet through g exactly once,
+ * in O(C(n,d-3)) planar event sweeps instead of the O(C(n,d-2)) of
+ * zonotope_halfspaces.
+ *
+ * The facets are stored in terms of the internal generators, which
+ * must be integral with a scaling factor of 1 (as they are for the
+ * user types long and mpz_class).
+ */
+template <typename User_number_t,
+          typename Internal_number_t = mpz_class>
+class Incremental_zonotope_halfspaces {
+public:
+  typedef std::vector<User_number_t> Vector_t;
+  typedef Hyperplane<User_number_t> Hyperplane_t;
+  typedef std::vector<Internal_number_t> Normal_t;
+
+  /**
+   * @brief The zonotope with no generators in dimension d
+   */
+  Incremental_zonotope_halfspaces( const int d )
+    : d_(d)
+    { }
+
+  Incremental_zonotope_halfspaces( const std::vector<Vector_t>& generators )
+    : d_(generators[0].size())
+  {
+    preprocess_generators<User_number_t, Internal_number_t>
+      (generators, internal_generators_);
+    const int n = generators.size();
+    generators_.assign(n, Normal_t(d_));
+    for ( int k = 0; k < n; ++k ) {
+      for ( int j = 0; j < d_; ++j ) {
+        generators_[k][j] = internal_generators_[k][j];
+      }
+    }
+    Facet_sink sink { *this, nullptr };
+    zonotope_halfspaces_stream<Internal_number_t, Internal_number_t>
+      (generators_, sink);
+  }
+
+  int dimension() const {
+    return d_;
+  }
+
+  int num_generators() const {
+    return generators_.size();
+  }
+
+  long num_halfspaces() const {
+    return facets_.size();
+  }
+
+  /**
+   * @brief Add the generator g, and update the halfspaces
+   */
+  void add_generator( const Vector_t& g ) {
+    // g goes first, so that the traversal can start from {g}
+    const int n = generators_.size();
+    const std::vector<Vector_t> g_in (1, g);
+    preprocess_generators<User_number_t, Internal_number_t> (g_in, internal_generators_);
+    Normal_t g_internal (internal_generators_[0].begin(), internal_generators_[0].end());
+    internal_generators_.resize(n + 1, d_);
+    for ( int k = 0; k < n; ++k ) {
+      for ( int j = 0; j < d_; ++j ) {
+        internal_generators_[k+1][j] = generators_[k][j];
+      }
+    }
+    for ( int j = 0; j < d_; ++j ) {
+      internal_generators_[0][j] = g_internal[j];
+    }
+
+    // the facets that are not parallel to g move outwards
+    Internal_number_t s;
+    for ( auto& facet : facets_ ) {
+      s = dot<Internal_number_t>(facet.first, g_internal);
+      if ( s < 0 ) {
+        facet.second -= s;
+      }
+    }
+
+    add_facets_through_new_generator(g_internal);
+    generators_.push_back(g_internal);
+  }
+
+  /**
+   * @brief Insert the halfspaces into a container, with
+   *        `halfspaces.insert(halfspaces.end(), h)` (see
+   *        zonotope_halfspaces_parallel)
+   */
+  template <typename Halfspaces_container_t>
+  void halfspaces( Halfspaces_container_t& halfspaces ) const {
+    Type_casting_functor<Hyperplane<Internal_number_t>, Hyperplane_t> Cast_to_user_type;
+    for ( const auto& facet : facets_ ) {
+      const Hyperplane<Internal_number_t> h (facet.second, facet.first);
+      halfspaces.insert(halfspaces.end(), Cast_to_user_type(h));
+    }
+  }
+
+private:
+
+  /**
+   * @brief Stores the facets by normal. If `new_generator` is set, only
+   *        the facets parallel to it are taken (for d = 2, where the
+   *        traversal cannot be restricted to the combinations
+   *        containing it).
+   */
+  struct Facet_sink {
+    Incremental_zonotope_halfspaces& halfspaces;
+    const Normal_t* new_generator;
+
+    void operator() (const Hyperplane<Internal_number_t>& h) {
+      if ( new_generator && dot<Internal_number_t>(h.normal, *new_generator) != 0 ) {
+        return;
+      }
+      // a facet that was parallel to the new generator is found again,
+      // with the same offset
+      halfspaces.facets_.insert( std::make_pair(h.normal, h.offset) );
+    }
+  };
+
+  typedef Combination_kernel_stack<Internal_number_t> Combination_container_t;
+  typedef Zonotope_halfspaces_output_functor<Internal_number_t,
+                                             Combination_container_t,
+                                             Facet_sink>
+      Traversal_output_functor_t;
+
+  /**
+   * @brief Traverse the (d-2)-combinations of internal_generators_ that
+   *        contain g (row 0).
+   */
+  void add_facets_through_new_generator( const Normal_t& g ) {
+    if ( d_ < 2 ) {
+      return;
+    }
+    Combination_container_t combination (internal_generators_, d_-1);
+    Facet_sink sink { *this, nullptr };
+    if ( d_ == 2 ) {
+      sink.new_generator = &g;
+    } else {
+      combination.extend(0);
+      if ( ! combination.is_valid() ) {
+        // g = 0
+        return;
+      }
+    }
+
+    Traversal_output_functor_t traversal_output (internal_generators_, sink);
+    traverse_combinations_in_place<Combination_container_t, Traversal_output_functor_t>
+      (combination, traversal_output);
+  }
+
+  int d_;
+
+  /**
+   * The internal generators, in the order they were added
+   */
+  std::vector<Normal_t> generators_;
+
+  /**
+   * Scratch space for add_generator: the new generator in row 0,
+   * followed by generators_
+   */
+  Matrix<Internal_number_t> internal_generators_;
+
+  /**
+   * The offset of every facet, by its normal
+   */
+  std::map<Normal_t, Internal_number_t> facets_;
+};
+
+} // namespace zonotope
+
+#endif // ZONOTOPE_HALFSPACES_INCREMENTAL_HPP_
@@ -7,6 +7,7 @@
 #include "container_output_functor.hpp"
 #include "output_functor_base.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 
@@ -21,28 +22,40 @@ struct Zonotope_halfspaces_output_functor : Output_functor_base<NT>
   
   Halfspaces_container_output_functor& Output_fn;
 
+  /**
+   * Reused by every call to handle_event_points
+   */
+  Event_point_buffer<NT> event_buffer;
+
   Zonotope_halfspaces_output_functor (
     const Generator_container_t& generators,
     Halfspaces_container_output_functor& Output_fn )
     : Output_functor_base<NT>(generators),
-      Output_fn( Output_fn )
+      Output_fn( Output_fn ),
+      event_buffer( generators )
   {}
 
   bool operator() (const Combination_container& combination) {
 
-    using std::vector;
+    if ( int(combination.size()) == (this->d)-2 ) {
 
-    if ( combination.size() == (this->d)-2 ) {
+      const Generator_container_t& generators = this->generators;
+      auto spanned_by_smaller = [&combination, &generators] ( const int j ) {
+        const std::vector<int>& elements = combination.elements;
+        const auto it = std::lower_bound(elements.begin(), elements.end(), j);
+        if ( it != elements.end() && *it == j ) {
+          return true;
+        }
+        return combination.prefix_spans( it - elements.begin(), generators[j] );
+      };
 
-      handle_event_points<NT,
-                          vector<NT>,
-                          vector<vector<NT> >,
-                          Halfspaces_container_output_functor>
+      handle_event_points<NT>
         ( combination.back(),
-          combination.elements,
-          combination.kernel[0],
-          combination.kernel[1],
-          this->generators,
+          combination.kernel_row(0),
+          combination.kernel_row(1),
+          generators,
+          spanned_by_smaller,
+          event_buffer,
           Output_fn );
       
       return true;
@@ -0,0 +1,279 @@
+#ifndef ZONOTOPE_VERTEX_ADJACENCY_ORACLE_HPP_
+#define ZONOTOPE_VERTEX_ADJACENCY_ORACLE_HPP_
+
+#include "zonotope_halfspaces.hpp"
+#include "linalg.hpp"
+#include "matrix.hpp"
+#include "packed_sign_vector.hpp"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <gmpxx.h>
+
+namespace zonotope {
+
+/**
+ * @brief A combinatorial vertex adjacency oracle for zonotope_vertices
+ *
+ * Same interface as Zonotope_vertex_adjacency_oracle_CGAL, but instead
+ * of solving a linear program for every query, it computes the facets
+ * of the zonotope once (with zonotope_halfspaces_stream), and decides
+ * adjacency from them: two vertices of a d-polytope span an edge iff
+ * the normals of the facets that contain both of them have rank d-1.
+ *
+ * The vertex with sign vector s lies on the facet with outward normal
+ * c iff s[i] is true for every segment i with dot(g_i, c) > 0, and
+ * false for every segment with dot(g_i, c) < 0, where g_i is the
+ * direction of the segment. Flipping s[k] keeps the vertex on the
+ * facet iff dot(g_k, c) = 0. So a query only looks at the facets that
+ * are parallel to g_k, and tests each of them with a few word
+ * operations on the sign patterns, which are precomputed as bitsets.
+ *
+ * If the segments do not span the whole space, the zonotope is
+ * replaced by its projection to a set of coordinates on which the
+ * projection of the span is injective. That does not change the sign
+ * vectors of the vertices.
+ *
+ * The queries keep their scratch space in thread-local storage, so one
+ * instance can be shared between threads.
+ */
+template <typename Input_number_t>
+struct Zonotope_vertex_adjacency_oracle {
+
+  typedef std::vector<bool> Cell_t;
+  typedef std::vector<Input_number_t> Vector_t;
+  typedef std::pair<Vector_t, Vector_t> Segment_t;
+  typedef std::vector<Segment_t> Generator_container_t;
+  typedef std::uint64_t Word_t;
+
+  const Generator_container_t& generators_;
+  const int d_;
+  const int n_;
+
+  Zonotope_vertex_adjacency_oracle(const Generator_container_t& generators) :
+    generators_(generators),
+    d_(generators[0].first.size()),
+    n_(generators.size()),
+    num_words_((n_ + 63) / 64),
+    facets_parallel_to_(n_)
+  {
+    using std::vector;
+
+    // the direction of segment i is g_i = first - second
+    vector<vector<mpq_class> > directions (n_, vector<mpq_class> (d_));
+    for ( int i = 0; i < n_; ++i ) {
+      for ( int j = 0; j < d_; ++j ) {
+        directions[i][j] = mpq_class(generators_[i].first[j]) - mpq_class(generators_[i].second[j]);
+      }
+    }
+
+    directions = independent_coordinates(directions);
+    rank_ = directions.empty() ? 0 : directions[0].size();
+    if ( rank_ < 2 ) {
+      // all segments are parallel, so the zonotope is a segment
+      return;
+    }
+
+    // scaling the directions to integers changes neither the facets
+    // nor the sign patterns
+    Matrix<mpz_class> scaled_directions;
+    preprocess_generators(directions, scaled_directions);
+    vector<vector<mpz_class> > integer_directions (n_, vector<mpz_class> (rank_));
+    for ( int i = 0; i < n_; ++i ) {
+      for ( int j = 0; j < rank_; ++j ) {
+        integer_directions[i][j] = scaled_directions[i][j];
+      }
+    }
+
+    Facet_sink sink { *this, integer_directions };
+    zonotope_halfspaces_stream<mpz_class, mpz_class>(integer_directions, sink);
+  }
+
+  bool operator() (const Cell_t& sign_vector, const int k) const {
+    static thread_local std::vector<Word_t> cell_words;
+    cell_words.assign(num_words_, 0);
+    for ( int i = 0; i < n_; ++i ) {
+      if ( sign_vector[i] ) {
+        cell_words[i >> 6] |= Word_t(1) << (i & 63);
+      }
+    }
+    return is_adjacent(cell_words.data(), k);
+  }
+
+  /**
+   * @brief Same as above, but reads the words of the sign vector
+   *        directly.
+   */
+  template <int NUM_WORDS>
+  bool operator() (const Packed_sign_vector<NUM_WORDS>& sign_vector, const int k) const {
+    return is_adjacent(sign_vector.words(), k);
+  }
+
+private:
+
+  /**
+   * @brief The query for the sign vector with the given words
+   */
+  bool is_adjacent(const Word_t* cell_words, const int k) const {
+    if ( rank_ < 2 ) {
+      return true;
+    }
+
+    // every facet normal parallel to g_k is orthogonal to g_k, so the
+    // kernel of the normals on both vertices has dimension at least 1
+    static thread_local Matrix<mpz_class> kernel;
+    bool kernel_initialized = false;
+    int kernel_size = rank_;
+
+    for ( const int f : facets_parallel_to_[k] ) {
+      if ( contains_vertex(f, cell_words) ) {
+        if ( ! kernel_initialized ) {
+          // most queries reject every facet
+          kernel.resize(rank_, rank_);
+          for ( int i = 0; i < rank_; ++i ) {
+            for ( int j = 0; j < rank_; ++j ) {
+              kernel[i][j] = ( i == j ) ? 1 : 0;
+            }
+          }
+          kernel_initialized = true;
+        }
+        update_kernel<mpz_class>(kernel, kernel_size, normals_[f]);
+        if ( kernel_size == 1 ) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Stores one normal of each pair of opposite facets, with its
+   *        sign pattern on the segments.
+   */
+  struct Facet_sink {
+    Zonotope_vertex_adjacency_oracle& oracle;
+    const std::vector<std::vector<mpz_class> >& directions;
+
+    void operator() (const Hyperplane<mpz_class>& h) {
+      const int d = h.normal.size();
+      int r = 0;
+      while ( r < d && h.normal[r] == 0 ) {
+        ++r;
+      }
+      if ( r == d || h.normal[r] < 0 ) {
+        // the opposite facet has the same sign pattern, up to sign
+        return;
+      }
+
+      const int f = oracle.normals_.size();
+      oracle.normals_.push_back(h.normal);
+      oracle.positive_.resize(oracle.positive_.size() + oracle.num_words_, 0);
+      oracle.negative_.resize(oracle.negative_.size() + oracle.num_words_, 0);
+      Word_t* positive = oracle.positive_.data() + f * oracle.num_words_;
+      Word_t* negative = oracle.negative_.data() + f * oracle.num_words_;
+
+      for ( int i = 0; i < oracle.n_; ++i ) {
+        const int x = sgn(dot<mpz_class>(directions[i], h.normal));
+        const Word_t bit = Word_t(1) << (i & 63);
+        if ( x > 0 ) {
+          positive[i >> 6] |= bit;
+        } else if ( x < 0 ) {
+          negative[i >> 6] |= bit;
+        } else {
+          oracle.facets_parallel_to_[i].push_back(f);
+        }
+      }
+    }
+  };
+
+  /**
+   * @brief Restrict the directions to a maximal set of coordinates on
+   *        which they are independent (the pivot columns of their row
+   *        echelon form), so that they span the whole space.
+   */
+  static std::vector<std::vector<mpq_class> >
+  independent_coordinates(const std::vector<std::vector<mpq_class> >& directions) {
+    const int n = directions.size();
+    const int d = directions[0].size();
+
+    std::vector<std::vector<mpq_class> > echelon = directions;
+    std::vector<int> pivot_columns;
+    int r = 0;
+    for ( int j = 0; j < d && r < n; ++j ) {
+      int p = r;
+      while ( p < n && echelon[p][j] == 0 ) {
+        ++p;
+      }
+      if ( p == n ) {
+        continue;
+      }
+      std::swap(echelon[p], echelon[r]);
+      for ( int i = r+1; i < n; ++i ) {
+        if ( echelon[i][j] != 0 ) {
+          const mpq_class factor = echelon[i][j] / echelon[r][j];
+          for ( int s = j; s < d; ++s ) {
+            echelon[i][s] -= factor * echelon[r][s];
+          }
+        }
+      }
+      pivot_columns.push_back(j);
+      ++r;
+    }
+
+    std::vector<std::vector<mpq_class> > projected (n, std::vector<mpq_class> (r));
+    for ( int i = 0; i < n; ++i ) {
+      for ( int s = 0; s < r; ++s ) {
+        projected[i][s] = directions[i][pivot_columns[s]];
+      }
+    }
+    return projected;
+  }
+
+  /**
+   * @brief true iff the vertex of the packed sign vector cell_words
+   *        lies on the facet f, or on the opposite facet.
+   */
+  bool contains_vertex(const int f, const Word_t* cell_words) const {
+    const Word_t* positive = positive_.data() + f * num_words_;
+    const Word_t* negative = negative_.data() + f * num_words_;
+    bool on_facet = true;
+    bool on_opposite = true;
+    for ( int w = 0; w < num_words_; ++w ) {
+      const Word_t cell = cell_words[w];
+      on_facet = on_facet && ( ( positive[w] & ~cell ) | ( negative[w] & cell ) ) == 0;
+      on_opposite = on_opposite && ( ( negative[w] & ~cell ) | ( positive[w] & cell ) ) == 0;
+      if ( ! on_facet && ! on_opposite ) {
+        // most facets are rejected by the first word
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const int num_words_;
+  int rank_;
+
+  /**
+   * One normal of every pair of opposite facets
+   */
+  std::vector<std::vector<mpz_class> > normals_;
+
+  /**
+   * The bits of segment i in words f*num_words_.. of positive_ and
+   * negative_ are set iff dot(g_i, normals_[f]) is positive and
+   * negative respectively.
+   */
+  std::vector<Word_t> positive_;
+  std::vector<Word_t> negative_;
+
+  /**
+   * facets_parallel_to_[i] lists the facets f with
+   * dot(g_i, normals_[f]) = 0
+   */
+  std::vector<std::vector<int> > facets_parallel_to_;
+};
+
+} // namespace zonotope
+
+#endif // ZONOTOPE_VERTEX_ADJACENCY_ORACLE_HPP_
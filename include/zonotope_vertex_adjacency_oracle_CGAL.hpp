@@ -28,7 +28,11 @@ struct Zonotope_vertex_adjacency_oracle_CGAL {
     d_(generators[0].first.size()),
     n_(generators.size()) {}
 
-  bool operator() (const Cell_t& sign_vector, const int k) const {
+  /**
+   * The sign vector can be a Cell_t or a Packed_sign_vector
+   */
+  template <typename Sign_vector_t>
+  bool operator() (const Sign_vector_t& sign_vector, const int k) const {
 
     typedef CGAL::Quadratic_program<Input_number_t> Program;
     typedef CGAL::Quadratic_program_solution<Exact_number_t> Solution;
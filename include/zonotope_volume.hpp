@@ -2,54 +2,369 @@
 #define ZONOTOPE_VOLUME_HPP_
 
 #include "combination_traversal.hpp"
+#include "parallel_combination_traversal.hpp"
 #include "zonotope_volume_output_functor.hpp"
-#include "combination_inverse_container.hpp"
+#include "combination_inverse_stack.hpp"
+#include "combination_lu_stack.hpp"
 #include "preprocess_generators.hpp"
 #include "type_casting_functor.hpp"
+#include "work_stealing.hpp"
+#include "fixed_dimension.hpp"
+#include "matrix.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <type_traits>
 #include <vector>
 #include <gmpxx.h>
 #include <cmath>
 
 namespace zonotope {
 
-template <typename T>
-T _pow(const T& x, unsigned int n) {}
+/**
+ * @brief The combination container of zonotope_volume for an internal
+ *        number type
+ *
+ * The exact types use the fraction-free Combination_inverse_stack, and
+ * double uses the floating-point Combination_lu_stack, so
+ * `zonotope_volume<double, double>` computes an approximate volume.
+ * Only the former has a variant for a compile-time dimension D.
+ */
+template <typename Internal_number_t, int D = 0>
+struct Volume_combination_container {
+  typedef Combination_inverse_stack<Internal_number_t, D> type;
+  typedef std::true_type has_fixed_dimension;
+};
 
-template <>
-mpz_class _pow<mpz_class>(const mpz_class& x, unsigned int n) {
-  mpz_class y;
-  mpz_pow_ui(y.get_mpz_t(), x.get_mpz_t(), n);
-  return y;
+template <int D>
+struct Volume_combination_container<double, D> {
+  typedef Combination_lu_stack<double> type;
+  typedef std::false_type has_fixed_dimension;
+};
+
+/**
+ * @brief The traversal of zonotope_volume over the preprocessed
+ *        generators, with the container for the dimension D (see
+ *        dispatch_dimension)
+ */
+template <typename Internal_number_t>
+struct _Zonotope_volume_traversal {
+  typedef Internal_number_t result_type;
+
+  const Matrix<Internal_number_t>& generators;
+
+  template <int D>
+  Internal_number_t run() {
+    typedef typename Volume_combination_container<Internal_number_t, D>::type Combination_container_t;
+    typedef Zonotope_volume_output_functor<Internal_number_t, Combination_container_t> Output_functor_t;
+
+    Combination_container_t empty_combination (generators, generators.cols());
+    Output_functor_t zonotope_volume_output (generators);
+
+    traverse_combinations_in_place<Combination_container_t, Output_functor_t>
+      (empty_combination, zonotope_volume_output);
+    return zonotope_volume_output.volume;
+  }
+};
+
+template <typename Internal_number_t>
+Internal_number_t _zonotope_volume_traversal (
+  _Zonotope_volume_traversal<Internal_number_t>& traversal,
+  std::true_type )
+{
+  return dispatch_dimension(traversal.generators.cols(), traversal);
+}
+
+template <typename Internal_number_t>
+Internal_number_t _zonotope_volume_traversal (
+  _Zonotope_volume_traversal<Internal_number_t>& traversal,
+  std::false_type )
+{
+  return traversal.template run<0>();
 }
 
+/**
+ * @brief An approximate volume with a bound on its error
+ */
+template <typename NT>
+struct Volume_estimate {
+  NT volume;
+  NT error_bound;
+};
+
+/**
+ * @brief The volume of a zonotope
+ *
+ * The parallel generators are merged first (see
+ * merge_parallel_generators_in_place), so that the traversal only runs
+ * over the d-combinations of the classes of parallel generators. For
+ * small d, the exact container is instantiated for the dimension (see
+ * dispatch_dimension).
+ */
 template <typename User_number_t = mpz_class,
           typename Internal_number_t = mpz_class>
 User_number_t zonotope_volume (const std::vector<std::vector<User_number_t> >& generators) {
 
-  typedef Combination_inverse_container<Internal_number_t> Combination_container_t;
+  typedef typename Volume_combination_container<Internal_number_t>::has_fixed_dimension Has_fixed_dimension_t;
+  Type_casting_functor<Internal_number_t, User_number_t> Cast_to_user_type;
+
+  const int d = generators[0].size();
+
+  Matrix<Internal_number_t> internal_generators;
+  Internal_number_t scaling_factor;
+  preprocess_generators(generators, internal_generators, scaling_factor);
+
+  // the translation does not change the volume
+  std::vector<Internal_number_t> translation;
+  merge_parallel_generators_in_place(internal_generators, translation);
+
+  _Zonotope_volume_traversal<Internal_number_t> traversal { internal_generators };
+  const Internal_number_t internal_volume =
+    _zonotope_volume_traversal(traversal, Has_fixed_dimension_t());
+
+  User_number_t volume = Cast_to_user_type(internal_volume);
+  scaling_factor = _pow<Internal_number_t> (scaling_factor, d);
+  volume /= Cast_to_user_type(scaling_factor);
+  
+  return volume;
+}
+
+/**
+ * @brief Same as zonotope_volume, but traverses the combinations on
+ *        several threads.
+ *
+ * @param num_threads The number of worker threads, or 0 to use one
+ *                    per hardware thread.
+ *
+ * @param split_depth The size of the prefix combinations that are
+ *                    distributed among the workers, or 0 to choose
+ *                    one from n, d and num_threads.
+ */
+template <typename User_number_t = mpz_class,
+          typename Internal_number_t = mpz_class>
+User_number_t zonotope_volume_parallel (
+  const std::vector<std::vector<User_number_t> >& generators,
+  int num_threads = 0,
+  int split_depth = 0 )
+{
+  typedef typename Volume_combination_container<Internal_number_t>::type Combination_container_t;
   typedef Zonotope_volume_output_functor<Internal_number_t, Combination_container_t> Output_functor_t;
   Type_casting_functor<Internal_number_t, User_number_t> Cast_to_user_type;
 
   const int d = generators[0].size();
 
-  std::vector<std::vector<Internal_number_t> > internal_generators;
+  Matrix<Internal_number_t> internal_generators;
   Internal_number_t scaling_factor;
   preprocess_generators(generators, internal_generators, scaling_factor);
 
+  std::vector<Internal_number_t> translation;
+  merge_parallel_generators_in_place(internal_generators, translation);
+  const int n = internal_generators.rows();
+
+  if ( num_threads <= 0 ) {
+    num_threads = default_num_threads();
+  }
+  if ( split_depth <= 0 ) {
+    split_depth = default_split_depth(n, d, num_threads);
+  }
+
   Combination_container_t empty_combination (internal_generators, d);
-  Output_functor_t zonotope_volume_output (internal_generators);
+  std::vector<Output_functor_t> zonotope_volume_outputs
+    (num_threads, Output_functor_t(internal_generators));
 
-  traverse_combinations<Combination_container_t, Output_functor_t>
-    (empty_combination, zonotope_volume_output);
+  traverse_combinations_parallel<Combination_container_t, Output_functor_t>
+    (empty_combination, zonotope_volume_outputs, split_depth);
+
+  // sum the partial volumes of the workers
+  Internal_number_t internal_volume = 0;
+  for ( const Output_functor_t& output : zonotope_volume_outputs ) {
+    internal_volume += output.volume;
+  }
 
-  User_number_t volume = Cast_to_user_type(zonotope_volume_output.volume);
+  User_number_t volume = Cast_to_user_type(internal_volume);
   scaling_factor = _pow<Internal_number_t> (scaling_factor, d);
   volume /= Cast_to_user_type(scaling_factor);
-  
+
   return volume;
 }
 
+/**
+ * @brief The volume of a zonotope in double precision, with an
+ *        estimated bound on its error.
+ *
+ * Traverses the same combinations as zonotope_volume, but with
+ * Combination_lu_stack in place of the exact fraction-free updates,
+ * so it neither converts to rationals nor allocates bignums. The
+ * error bound adds three parts. The first is the first-order
+ * estimates of the rounding errors of the determinants. The second
+ * bounds the combinations that were pruned as numerically singular.
+ * The third is the rounding error of the sum. The conversion of the
+ * generators to double is assumed to be exact.
+ */
+template <typename User_number_t>
+Volume_estimate<double> zonotope_volume_approx (
+  const std::vector<std::vector<User_number_t> >& generators )
+{
+  typedef Combination_lu_stack<double> Combination_container_t;
+  typedef Zonotope_volume_error_output_functor<double, Combination_container_t> Output_functor_t;
+  Type_casting_functor<User_number_t, double> Cast_to_double;
+
+  const int n = generators.size();
+  const int d = generators[0].size();
+
+  Matrix<double> internal_generators (n, d);
+  for ( int k = 0; k < n; ++k ) {
+    for ( int i = 0; i < d; ++i ) {
+      internal_generators[k][i] = Cast_to_double(generators[k][i]);
+    }
+  }
+
+  Combination_container_t empty_combination (internal_generators, d);
+  Output_functor_t zonotope_volume_output (internal_generators);
+
+  traverse_combinations_in_place<Combination_container_t, Output_functor_t>
+    (empty_combination, zonotope_volume_output);
+
+  // each addition to the sum of positive terms has a relative error of
+  // at most u
+  const double u = std::numeric_limits<double>::epsilon() / 2;
+  const double summation_error =
+    zonotope_volume_output.num_terms * u * zonotope_volume_output.volume;
+
+  Volume_estimate<double> estimate;
+  estimate.volume = zonotope_volume_output.volume;
+  estimate.error_bound = zonotope_volume_output.error_bound
+    + empty_combination.pruned_error_bound
+    + summation_error;
+  return estimate;
+}
+
+/**
+ * @brief Reusable storage for computing the volumes of many zonotopes
+ *        one after the other.
+ *
+ * Keeps the generator matrices and the combination stack from call to
+ * call, so that computing the volumes of a sequence of zonotopes of
+ * the same size performs no heap allocations after the first one (for
+ * internal number types that reuse their storage on assignment). As
+ * in zonotope_volume, the parallel generators are merged first (see
+ * merge_parallel_generators_in_place).
+ */
+template <typename User_number_t = mpz_class,
+          typename Internal_number_t = mpz_class>
+class Zonotope_volume_workspace {
+public:
+
+  typedef Combination_inverse_stack<Internal_number_t> Combination_container_t;
+  typedef Zonotope_volume_output_functor<Internal_number_t, Combination_container_t> Output_functor_t;
+
+  Zonotope_volume_workspace()
+    : empty_combination_ (internal_generators_, 0)
+    { }
+
+  // the combination stack refers to internal_generators_
+  Zonotope_volume_workspace( const Zonotope_volume_workspace& ) = delete;
+  Zonotope_volume_workspace& operator= ( const Zonotope_volume_workspace& ) = delete;
+
+  /**
+   * @brief The volume of the zonotope with the given n-by-d generator
+   *        matrix (one generator per row)
+   */
+  User_number_t operator() ( const Matrix_view<const User_number_t>& generators ) {
+    const int n = generators.rows();
+    const int d = generators.cols();
+
+    generators_in_.resize(n);
+    for ( int k = 0; k < n; ++k ) {
+      const auto& v = generators[k];
+      generators_in_[k].assign(v.begin(), v.end());
+    }
+    preprocess_generators(generators_in_, internal_generators_, scaling_factor_);
+
+    // the translation does not change the volume
+    merge_parallel_generators_in_place(internal_generators_, translation_);
+
+    empty_combination_.reset(d);
+    span_marks_.reset(empty_combination_.MAX_ELEMENT);
+    Output_functor_t zonotope_volume_output (internal_generators_);
+
+    traverse_combinations_in_place<Combination_container_t, Output_functor_t>
+      (empty_combination_, zonotope_volume_output, span_marks_);
+
+    User_number_t volume = Cast_to_user_type(zonotope_volume_output.volume);
+    scaling_factor_ = _pow<Internal_number_t> (scaling_factor_, d);
+    volume /= Cast_to_user_type(scaling_factor_);
+
+    return volume;
+  }
+
+private:
+  Type_casting_functor<Internal_number_t, User_number_t> Cast_to_user_type;
+  std::vector<std::vector<User_number_t> > generators_in_;
+  Matrix<Internal_number_t> internal_generators_;
+  std::vector<Internal_number_t> translation_;
+  Internal_number_t scaling_factor_;
+  Combination_container_t empty_combination_;
+  Combination_span_marks span_marks_;
+};
+
+/**
+ * @brief Compute the volumes of many zonotopes on several threads.
+ *
+ * The zonotopes are split into consecutive chunks, which are handed
+ * out to work-stealing workers (see parallel_for_each_task). Each
+ * worker reuses a single Zonotope_volume_workspace for all of its
+ * zonotopes.
+ *
+ * @param num_zonotopes The number of zonotopes
+ *
+ * @param generators_of A functor such that `generators_of(k)` is a
+ *                      Matrix_view<const User_number_t> of the n-by-d
+ *                      generator matrix of zonotope k. It is called
+ *                      concurrently from the workers.
+ *
+ * @param volumes On exit, volumes[k] is the volume of zonotope k
+ *
+ * @param num_threads The number of worker threads, or 0 to use one
+ *                    per hardware thread.
+ */
+template <typename User_number_t = mpz_class,
+          typename Internal_number_t = mpz_class,
+          typename Generators_functor>
+void zonotope_volume_batch ( const int num_zonotopes,
+                             const Generators_functor& generators_of,
+                             User_number_t* volumes,
+                             int num_threads = 0 )
+{
+  typedef Zonotope_volume_workspace<User_number_t, Internal_number_t> Workspace_t;
+
+  if ( num_zonotopes <= 0 ) {
+    return;
+  }
+  if ( num_threads <= 0 ) {
+    num_threads = default_num_threads();
+  }
+  num_threads = std::min(num_threads, num_zonotopes);
+
+  // a few chunks per worker, so that the workers can balance uneven
+  // zonotopes by stealing, without taking a lock for every zonotope
+  const int num_chunks = std::min(num_zonotopes, 16 * num_threads);
+  const int chunk_size = ( num_zonotopes + num_chunks - 1 ) / num_chunks;
+
+  std::vector<Workspace_t> workspaces (num_threads);
+
+  auto compute_chunk = [&] ( const int chunk, const int thread_index ) {
+    Workspace_t& workspace = workspaces[thread_index];
+    const int first = chunk * chunk_size;
+    const int last = std::min(first + chunk_size, num_zonotopes);
+    for ( int k = first; k < last; ++k ) {
+      volumes[k] = workspace(generators_of(k));
+    }
+  };
+
+  parallel_for_each_task( num_chunks, num_threads, compute_chunk );
+}
+
 } // namespace zonotope
  
 #endif // ZONOTOPE_VOLUME_HPP_
@@ -21,8 +21,44 @@ struct Zonotope_volume_output_functor : Output_functor_base<NT>
   { }
 
   bool operator() (const Combination_container& combination) {
-    if ( combination.size() == (this->d) ) {
-      volume += abs(combination.determinant);
+    if ( int(combination.size()) == (this->d) ) {
+      // same as volume += abs(determinant), without a temporary
+      if ( combination.determinant < 0 ) {
+        volume -= combination.determinant;
+      } else {
+        volume += combination.determinant;
+      }
+      return true;
+    }
+    return false;
+  }
+};
+
+/**
+ * @brief Same as Zonotope_volume_output_functor, but also sums the
+ *        error bounds of the determinants, for containers like
+ *        Combination_lu_stack that provide them.
+ */
+template <typename NT, typename Combination_container>
+struct Zonotope_volume_error_output_functor
+  : Zonotope_volume_output_functor<NT, Combination_container>
+{
+  typedef Zonotope_volume_output_functor<NT, Combination_container> Base_t;
+  using typename Base_t::Generator_container_t;
+
+  NT error_bound;
+  long num_terms;
+
+  Zonotope_volume_error_output_functor (const Generator_container_t& generators)
+    : Base_t (generators)
+    , error_bound (NT(0))
+    , num_terms (0)
+  { }
+
+  bool operator() (const Combination_container& combination) {
+    if ( Base_t::operator()(combination) ) {
+      error_bound += combination.error_bound;
+      ++num_terms;
       return true;
     }
     return false;
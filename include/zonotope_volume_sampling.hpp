@@ -0,0 +1,328 @@
+#ifndef ZONOTOPE_VOLUME_SAMPLING_HPP_
+#define ZONOTOPE_VOLUME_SAMPLING_HPP_
+
+#include "combination_lu_stack.hpp"
+#include "type_casting_functor.hpp"
+#include "work_stealing.hpp"
+#include "matrix.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace zonotope {
+
+/**
+ * @brief How zonotope_volume_sampling draws the d-subsets of generators
+ */
+enum Volume_sampling_scheme {
+  /**
+   * Every d-subset is equally likely.
+   */
+  UNIFORM_SAMPLING,
+
+  /**
+   * A d-subset is drawn with probability proportional to the product
+   * of the norms of its generators, which is the Hadamard bound on its
+   * determinant. This concentrates the samples on the subsets that
+   * can contribute the most.
+   */
+  NORM_PRODUCT_SAMPLING
+};
+
+struct Volume_sampling_options {
+  Volume_sampling_scheme scheme;
+
+  /**
+   * The number of samples, split evenly among the threads
+   */
+  long max_samples;
+
+  /**
+   * If positive, every thread stops once this many seconds have passed,
+   * even if it has not drawn all its samples.
+   */
+  double max_seconds;
+
+  /**
+   * The number of worker threads, or 0 to use one per hardware thread
+   */
+  int num_threads;
+
+  /**
+   * Thread t draws from its own generator, seeded with (seed, t), so
+   * the estimate only depends on the seed and the number of threads
+   * (unless the time budget runs out).
+   */
+  std::uint64_t seed;
+
+  Volume_sampling_options()
+    : scheme(NORM_PRODUCT_SAMPLING)
+    , max_samples(100000)
+    , max_seconds(0)
+    , num_threads(0)
+    , seed(0)
+    { }
+};
+
+/**
+ * @brief A Monte-Carlo estimate of a volume
+ */
+struct Volume_sampling_estimate {
+  /**
+   * The unbiased estimate of the volume
+   */
+  double volume;
+
+  /**
+   * The standard error of the estimate
+   */
+  double standard_error;
+
+  /**
+   * The bounds of the approximate 95% confidence interval
+   * volume +- 1.96*standard_error
+   */
+  double confidence_low;
+  double confidence_high;
+
+  long num_samples;
+};
+
+/**
+ * @brief Running sums of one worker of zonotope_volume_sampling
+ *
+ * The mean and the sum of squared deviations are updated as in
+ * Welford's algorithm, and merged as in Chan et al.
+ */
+struct _Volume_sample_statistics {
+  long count;
+  double mean;
+  double squared_deviations;
+
+  _Volume_sample_statistics() : count(0), mean(0), squared_deviations(0) {}
+
+  void add(const double x) {
+    ++count;
+    const double delta = x - mean;
+    mean += delta / count;
+    squared_deviations += delta * (x - mean);
+  }
+
+  void merge(const _Volume_sample_statistics& other) {
+    if ( other.count == 0 ) {
+      return;
+    }
+    const long total = count + other.count;
+    const double delta = other.mean - mean;
+    mean += delta * other.count / total;
+    squared_deviations += other.squared_deviations
+      + delta * delta * ( double(count) * other.count / total );
+    count = total;
+  }
+};
+
+/**
+ * @brief Draws d-subsets of n generators with probability proportional
+ *        to the product of their weights.
+ *
+ * Goes through the generators in order and takes generator i with the
+ * probability that a weighted d-subset of the generators i..n-1 that
+ * still needs k elements contains it. That probability is
+ * w_i * e_{k-1}(w_{i+1..n-1}) / e_k(w_{i..n-1}), where e_k is the
+ * elementary symmetric polynomial of degree k. The table of these
+ * polynomials is computed once, and each sample takes O(n) steps.
+ * The weights are normalized to mean 1, so that the table does not
+ * overflow for moderate n and d.
+ */
+class _Weighted_subset_sampler {
+public:
+  _Weighted_subset_sampler( const std::vector<double>& weights, const int d )
+    : n_(weights.size())
+    , d_(d)
+    , weights_(weights)
+    , elementary_((n_ + 1) * (d_ + 1), 0)
+  {
+    double total = 0;
+    for ( const double w : weights_ ) {
+      total += w;
+    }
+    if ( total > 0 ) {
+      for ( double& w : weights_ ) {
+        w *= n_ / total;
+      }
+    }
+    for ( int i = n_; i >= 0; --i ) {
+      e(i, 0) = 1;
+      for ( int k = 1; k <= d_; ++k ) {
+        e(i, k) = ( i == n_ ) ? 0 : e(i+1, k) + weights_[i] * e(i+1, k-1);
+      }
+    }
+  }
+
+  /**
+   * @brief e_d of the normalized weights, so that a subset is drawn
+   *        with probability (product of its weights) / total_weight()
+   */
+  double total_weight() const {
+    return elementary_[d_];
+  }
+
+  double weight(const int i) const {
+    return weights_[i];
+  }
+
+  /**
+   * @brief Draw a subset into elements, in increasing order
+   */
+  template <typename Random_engine>
+  void operator() ( Random_engine& rng, std::vector<int>& elements ) const {
+    std::uniform_real_distribution<double> uniform (0, 1);
+    elements.clear();
+    int k = d_;
+    for ( int i = 0; i < n_ && k > 0; ++i ) {
+      const double p = weights_[i] * e(i+1, k-1) / e(i, k);
+      if ( uniform(rng) < p ) {
+        elements.push_back(i);
+        --k;
+      }
+    }
+  }
+
+private:
+  double& e( const int i, const int k ) {
+    return elementary_[i * (d_ + 1) + k];
+  }
+
+  double e( const int i, const int k ) const {
+    return elementary_[i * (d_ + 1) + k];
+  }
+
+  const int n_;
+  const int d_;
+  std::vector<double> weights_;
+
+  /**
+   * e(i, k) is e_k(w_i, ..., w_{n-1})
+   */
+  std::vector<double> elementary_;
+};
+
+/**
+ * @brief Estimate the volume of a zonotope by sampling d-subsets of
+ *        its generators.
+ *
+ * The volume is the sum of |det| over all C(n,d) subsets of d
+ * generators. A subset S drawn with probability p(S) gives the
+ * unbiased estimate |det(S)| / p(S), and the estimate is the mean of
+ * max_samples such draws. The determinants are computed in double
+ * precision with Combination_lu_stack. Their rounding errors are
+ * negligible next to the sampling error.
+ *
+ * The threads run independent samplers. Their statistics are merged
+ * at the end.
+ */
+template <typename User_number_t>
+Volume_sampling_estimate zonotope_volume_sampling (
+  const std::vector<std::vector<User_number_t> >& generators,
+  const Volume_sampling_options& options = Volume_sampling_options() )
+{
+  typedef Combination_lu_stack<double> Combination_container_t;
+  typedef std::chrono::steady_clock Clock_t;
+  Type_casting_functor<User_number_t, double> Cast_to_double;
+
+  const int n = generators.size();
+  const int d = generators[0].size();
+
+  Volume_sampling_estimate estimate { 0, 0, 0, 0, 0 };
+  if ( n < d ) {
+    return estimate;
+  }
+
+  Matrix<double> internal_generators (n, d);
+  std::vector<double> weights (n, 1);
+  for ( int k = 0; k < n; ++k ) {
+    double squared_norm = 0;
+    for ( int i = 0; i < d; ++i ) {
+      internal_generators[k][i] = Cast_to_double(generators[k][i]);
+      squared_norm += internal_generators[k][i] * internal_generators[k][i];
+    }
+    if ( options.scheme == NORM_PRODUCT_SAMPLING ) {
+      weights[k] = std::sqrt(squared_norm);
+    }
+  }
+
+  const _Weighted_subset_sampler sample_subset (weights, d);
+  if ( sample_subset.total_weight() == 0 ) {
+    // fewer than d generators are nonzero
+    return estimate;
+  }
+
+  int num_threads = options.num_threads;
+  if ( num_threads <= 0 ) {
+    num_threads = default_num_threads();
+  }
+
+  const Clock_t::time_point start = Clock_t::now();
+  std::vector<_Volume_sample_statistics> statistics (num_threads);
+
+  auto run_sampler = [&] ( const int stream, const int ) {
+    std::seed_seq seeds { std::uint32_t(options.seed), std::uint32_t(options.seed >> 32),
+                          std::uint32_t(stream) };
+    std::mt19937_64 rng (seeds);
+    Combination_container_t combination (internal_generators, d);
+    std::vector<int> elements;
+    _Volume_sample_statistics& stats = statistics[stream];
+
+    const long num_samples = options.max_samples / num_threads
+      + ( stream < options.max_samples % num_threads ? 1 : 0 );
+    for ( long s = 0; s < num_samples; ++s ) {
+      if ( options.max_seconds > 0 && ( s & 255 ) == 0 ) {
+        const double elapsed = std::chrono::duration<double>(Clock_t::now() - start).count();
+        if ( elapsed > options.max_seconds ) {
+          break;
+        }
+      }
+
+      sample_subset(rng, elements);
+      double weight_product = 1;
+      for ( const int i : elements ) {
+        combination.extend(i);
+        weight_product *= sample_subset.weight(i);
+        if ( ! combination.is_valid() ) {
+          break;
+        }
+      }
+      const double determinant = combination.is_valid() ? combination.determinant : 0;
+      while ( combination.size() > 0 ) {
+        combination.retract();
+      }
+
+      stats.add( determinant * sample_subset.total_weight() / weight_product );
+    }
+  };
+
+  parallel_for_each_task( num_threads, num_threads, run_sampler );
+
+  _Volume_sample_statistics total;
+  for ( const _Volume_sample_statistics& stats : statistics ) {
+    total.merge(stats);
+  }
+
+  estimate.num_samples = total.count;
+  estimate.volume = total.mean;
+  if ( total.count > 1 ) {
+    const double variance = total.squared_deviations / (total.count - 1);
+    estimate.standard_error = std::sqrt(variance / total.count);
+  }
+  estimate.confidence_low = estimate.volume - 1.96 * estimate.standard_error;
+  estimate.confidence_high = estimate.volume + 1.96 * estimate.standard_error;
+  return estimate;
+}
+
+} // namespace zonotope
+
+#endif // ZONOTOPE_VOLUME_SAMPLING_HPP_
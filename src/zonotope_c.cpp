@@ -1,9 +1,9 @@
 #include "zonotope_volume.hpp"
 #include "zonotope_halfspaces.hpp"
+#include "checked_integer.hpp"
 
 #include "vertex_enum.hpp"
-#include "zonotope_vertex_adjacency_oracle_CGAL.hpp"
-#include <CGAL/Gmpzf.h>
+#include "zonotope_vertex_adjacency_oracle.hpp"
 
 
 #include <cstdlib>
@@ -55,29 +55,147 @@ zonotope_volume_ptr(int d, int n, const Number_t* generators)
 }
 
 template <typename Number_t>
-static long
-zonotope_halfspaces_ptr(const int d, const int n, const Number_t* generators, Number_t** halfspaces)
+static double
+zonotope_volume_approx_ptr(int d, int n, const Number_t* generators, double* error_bound)
 {
   using namespace zonotope;
-  using std::vector;
-  using std::set;
+  std::vector<std::vector<Number_t> > _generators;
+  array_to_matrix_2(n, d, true, generators, _generators);
+  const Volume_estimate<double> estimate = zonotope_volume_approx(_generators);
+  if ( error_bound ) {
+    *error_bound = estimate.error_bound;
+  }
+  return estimate.volume;
+}
 
-  vector<vector<Number_t> > _generators;
+template <typename Number_t>
+static Number_t
+zonotope_volume_parallel_ptr(int d, int n, const Number_t* generators, int num_threads)
+{
+  using namespace zonotope;
+  std::vector<std::vector<Number_t> > _generators;
   array_to_matrix_2(n, d, true, generators, _generators);
-  set<Hyperplane<Number_t> > _halfspaces;
-  zonotope_halfspaces<Number_t>(_generators, _halfspaces);
+  return zonotope_volume_parallel(_generators, num_threads);
+}
+
+/**
+ * The generators of the zonotopes in a packed batch. The column-major
+ * d-by-n matrix of a zonotope is the row-major n-by-d matrix of its
+ * generators, so each one is viewed in place, without a copy.
+ */
+template <typename Number_t>
+struct Packed_generators {
+  const int* d;
+  const int* n;
+  const Number_t* generators;
+  const long* offsets;
+
+  zonotope::Matrix_view<const Number_t> operator() (const int k) const {
+    return zonotope::Matrix_view<const Number_t> (generators + offsets[k], n[k], d[k], d[k]);
+  }
+};
 
-  (*halfspaces) = (Number_t*)malloc(sizeof(Number_t) * (d+1) * _halfspaces.size());
+template <typename Number_t>
+static void
+zonotope_volume_batch_ptr(const int num_zonotopes, const int* d, const int* n,
+                          const Number_t* generators, const long* offsets,
+                          Number_t* volumes, const int num_threads)
+{
+  using namespace zonotope;
+  Packed_generators<Number_t> generators_of { d, n, generators, offsets };
+  zonotope_volume_batch<Number_t, Checked_integer>
+    (num_zonotopes, generators_of, volumes, num_threads);
+}
 
-  typename set<Hyperplane<Number_t> >::size_type count = 0;
-  for ( const Hyperplane<Number_t>& h : _halfspaces ) {
-    (*halfspaces)[count++] = h.offset;
+/**
+ * Writes each halfspace as (d+1) numbers, the offset followed by the
+ * normal, to a reused row and passes the row to a callback.
+ */
+template <typename Number_t, typename Callback_t>
+struct Halfspace_row_sink {
+  std::vector<Number_t> row;
+  Callback_t callback;
+  void* user_data;
+
+  Halfspace_row_sink(const int d, Callback_t callback, void* user_data)
+    : row(d+1)
+    , callback(callback)
+    , user_data(user_data)
+    { }
+
+  void operator() (const zonotope::Hyperplane<Number_t>& h) {
+    const int d = h.normal.size();
+    row[0] = h.offset;
     for ( int i = 0; i < d; ++i ) {
-      (*halfspaces)[count++] = h.normal[i];
+      row[i+1] = h.normal[i];
     }
+    callback(row.data(), user_data);
   }
+};
+
+template <typename Number_t, typename Callback_t>
+static long
+zonotope_halfspaces_stream_ptr(const int d, const int n, const Number_t* generators,
+                               Callback_t callback, void* user_data)
+{
+  using namespace zonotope;
 
-  return _halfspaces.size();
+  std::vector<std::vector<Number_t> > _generators;
+  array_to_matrix_2(n, d, true, generators, _generators);
+  Halfspace_row_sink<Number_t, Callback_t> sink (d, callback, user_data);
+  return zonotope_halfspaces_stream<Number_t>(_generators, sink);
+}
+
+/**
+ * A growing malloc'd array of halfspaces, for zonotope_halfspaces_ptr
+ */
+template <typename Number_t>
+struct Halfspace_array {
+  Number_t* data;
+  long size;
+  long capacity;
+  int d;
+  bool failed; ///< true iff growing data failed
+};
+
+template <typename Number_t>
+static void
+append_halfspace(const Number_t* halfspace, void* user_data)
+{
+  Halfspace_array<Number_t>& array = *static_cast<Halfspace_array<Number_t>*>(user_data);
+  if ( array.failed ) {
+    return;
+  }
+  if ( array.size == array.capacity ) {
+    const long capacity = ( array.capacity > 0 ) ? 2 * array.capacity : 64;
+    Number_t* data = (Number_t*)realloc(array.data, sizeof(Number_t) * (array.d+1) * capacity);
+    if ( data == nullptr ) {
+      // keep the old buffer, so that it can be freed
+      array.failed = true;
+      return;
+    }
+    array.data = data;
+    array.capacity = capacity;
+  }
+  std::copy(halfspace, halfspace + array.d + 1, array.data + (array.d+1) * array.size);
+  ++array.size;
+}
+
+template <typename Number_t>
+static long
+zonotope_halfspaces_ptr(const int d, const int n, const Number_t* generators, Number_t** halfspaces)
+{
+  // the halfspaces are written straight to the output array, without
+  // collecting them in a set first
+  Halfspace_array<Number_t> array { nullptr, 0, 0, d, false };
+  zonotope_halfspaces_stream_ptr(d, n, generators, &append_halfspace<Number_t>, &array);
+  if ( array.failed ) {
+    free(array.data);
+    (*halfspaces) = nullptr;
+    return -1;
+  }
+  (*halfspaces) = array.data;
+  return array.size;
 }
 
 template <typename Number_t>
@@ -90,8 +208,7 @@ zonotope_vertices_ptr(const int d, const int n, const Number_t* generators, Numb
   vector<vector<Number_t> > _generators;
   array_to_matrix_2(n, d, true, generators, _generators);
 
-  typedef Zonotope_vertex_adjacency_oracle_CGAL<Number_t, CGAL::Gmpzf>
-      Adjacency_oracle_t;
+  typedef Zonotope_vertex_adjacency_oracle<Number_t> Adjacency_oracle_t;
 
   vector<vector<Number_t> > _vertices =
       zonotope_vertices<Number_t, Adjacency_oracle_t> (_generators);
@@ -129,6 +246,30 @@ double zonotope_volume_double(int d, int n, const double* generators) {
   return zonotope_volume_ptr<double>(d, n, generators);
 }
 
+double zonotope_volume_double_approx(int d, int n, const double* generators, double* error_bound) {
+  return zonotope_volume_approx_ptr<double>(d, n, generators, error_bound);
+}
+
+long zonotope_volume_parallel_long(int d, int n, const long* generators, int num_threads) {
+  return zonotope_volume_parallel_ptr<long>(d, n, generators, num_threads);
+}
+
+double zonotope_volume_parallel_double(int d, int n, const double* generators, int num_threads) {
+  return zonotope_volume_parallel_ptr<double>(d, n, generators, num_threads);
+}
+
+void zonotope_volume_batch_long(int num_zonotopes, const int* d, const int* n,
+                                const long* generators, const long* offsets,
+                                long* volumes, int num_threads) {
+  zonotope_volume_batch_ptr<long>(num_zonotopes, d, n, generators, offsets, volumes, num_threads);
+}
+
+void zonotope_volume_batch_double(int num_zonotopes, const int* d, const int* n,
+                                  const double* generators, const long* offsets,
+                                  double* volumes, int num_threads) {
+  zonotope_volume_batch_ptr<double>(num_zonotopes, d, n, generators, offsets, volumes, num_threads);
+}
+
 //
 // Halfspaces
 //
@@ -140,6 +281,16 @@ long zonotope_halfspaces_double(const int d, const int n, const double* generato
   return zonotope_halfspaces_ptr<double>(d, n, generators, halfspaces);
 }
 
+long zonotope_halfspaces_stream_long(const int d, const int n, const long* generators,
+                                     zonotope_halfspace_callback_long callback, void* user_data) {
+  return zonotope_halfspaces_stream_ptr<long>(d, n, generators, callback, user_data);
+}
+
+long zonotope_halfspaces_stream_double(const int d, const int n, const double* generators,
+                                       zonotope_halfspace_callback_double callback, void* user_data) {
+  return zonotope_halfspaces_stream_ptr<double>(d, n, generators, callback, user_data);
+}
+
 //
 // Vertices
 //
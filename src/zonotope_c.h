@@ -8,17 +8,84 @@
 long   zonotope_volume_long(  int d, int n, const long*   generators);
 double zonotope_volume_double(int d, int n, const double* generators);
 
+/**
+ * @brief zonotope_volume_double_approx Compute the volume of a zonotope in double precision
+ * @param d dimension of the output space
+ * @param n number of generators
+ * @param generators a d-by-n column major matrix of the generators
+ * @param error_bound if not NULL, on exit *error_bound is an estimated
+ *        bound on the absolute error of the result
+ * @return the approximate volume of the zonotope
+ */
+double zonotope_volume_double_approx(int d, int n, const double* generators, double* error_bound);
+
+/**
+ * @brief zonotope_volume_parallel_T Compute the volume of a zonotope on several threads
+ * @param d dimension of the output space
+ * @param n number of generators
+ * @param generators a d-by-n column major matrix of the generators
+ * @param num_threads the number of worker threads, or 0 for one per hardware thread
+ * @return the volume of the zonotope
+ */
+long   zonotope_volume_parallel_long(  int d, int n, const long*   generators, int num_threads);
+double zonotope_volume_parallel_double(int d, int n, const double* generators, int num_threads);
+
+/**
+ * @brief zonotope_volume_batch_T Compute the volumes of many zonotopes in one call
+ * @param num_zonotopes the number of zonotopes
+ * @param d d[k] is the dimension of the output space of zonotope k
+ * @param n n[k] is the number of generators of zonotope k
+ * @param generators the generator matrices of all the zonotopes, packed into one array
+ * @param offsets the d[k]-by-n[k] column major matrix of the generators of
+ *        zonotope k starts at generators + offsets[k]
+ * @param volumes an array of num_zonotopes numbers, allocated by the caller;
+ *        on exit, volumes[k] is the volume of zonotope k
+ * @param num_threads the number of worker threads, or 0 for one per hardware thread
+ */
+void zonotope_volume_batch_long(  int num_zonotopes, const int* d, const int* n,
+                                  const long*   generators, const long* offsets,
+                                  long*   volumes, int num_threads);
+void zonotope_volume_batch_double(int num_zonotopes, const int* d, const int* n,
+                                  const double* generators, const long* offsets,
+                                  double* volumes, int num_threads);
+
 /**
  * @brief zonotope_halfspaces_T Compute the hyperplane representation of a zonotope
  * @param d the dimension of the output space
  * @param n the number of generators
  * @param generators a d-by-n column major matrix of the generators
- * @param halfspaces on exit, *halfspaces points to the list of bounding halfspaces
- * @return the number of halfspaces in the output
+ * @param halfspaces on exit, *halfspaces points to a malloc'd list of the bounding
+ *        halfspaces, in no particular order; it is NULL if there are none
+ *        or if the list could not be allocated
+ * @return the number of halfspaces in the output, or -1 if the list could not be
+ *         allocated
  */
 long zonotope_halfspaces_long(  const int d, const int n, const long*   generators, long**   halfspaces);
 long zonotope_halfspaces_double(const int d, const int n, const double* generators, double** halfspaces);
 
+/**
+ * @brief A callback that receives one halfspace
+ * @param halfspace (d+1) numbers, the offset followed by the normal vector;
+ *        only valid for the duration of the call
+ * @param user_data the pointer that was passed to zonotope_halfspaces_stream_T
+ */
+typedef void (*zonotope_halfspace_callback_long)(  const long*   halfspace, void* user_data);
+typedef void (*zonotope_halfspace_callback_double)(const double* halfspace, void* user_data);
+
+/**
+ * @brief zonotope_halfspaces_stream_T Pass the halfspaces of a zonotope to a callback as they are found
+ * @param d the dimension of the output space
+ * @param n the number of generators
+ * @param generators a d-by-n column major matrix of the generators
+ * @param callback called once for every bounding halfspace, in no particular order
+ * @param user_data passed on to the callback
+ * @return the number of halfspaces in the output
+ */
+long zonotope_halfspaces_stream_long(  const int d, const int n, const long*   generators,
+                                       zonotope_halfspace_callback_long callback, void* user_data);
+long zonotope_halfspaces_stream_double(const int d, const int n, const double* generators,
+                                       zonotope_halfspace_callback_double callback, void* user_data);
+
 /**
  * @brief zonotope_vertices_T Compute the vertices of a zonotope
  * @param d the dimension of the output space
@@ -52,6 +52,18 @@ int main() {
     enumerate_cells_reverse_search<Number_t, Output_counter_functor> (A, b, output_counter);
     cout << output_counter.count;
 
+    Output_counter_functor stack_counter;
+    enumerate_cells_reverse_search_with_stack<Number_t, Output_counter_functor> (A, b, stack_counter);
+    cout << " " << stack_counter.count;
+
+    vector<Output_counter_functor> parallel_counters (4);
+    enumerate_cells_reverse_search_parallel<Number_t, Output_counter_functor> (A, b, parallel_counters);
+    int parallel_count = 0;
+    for ( const Output_counter_functor& counter : parallel_counters ) {
+      parallel_count += counter.count;
+    }
+    cout << " " << parallel_count;
+
     cout << "\n\n";
   }
 
@@ -1,5 +1,8 @@
 #include "vertex_enum.hpp"
 #include "zonotope_vertex_adjacency_oracle_CGAL.hpp"
+#include "zonotope_vertex_adjacency_oracle.hpp"
+#include "vertex_reverse_search.hpp"
+#include "zonotope_f_vector.hpp"
 
 #include <vector>
 #include <set>
@@ -8,12 +11,23 @@
 
 #include <CGAL/Gmpzf.h>
 
+struct Vertex_counter {
+  long count;
+
+  Vertex_counter() : count(0) {}
+
+  void operator() (const std::vector<long>&) {
+    ++count;
+  }
+};
+
 int main() {
   using namespace std;
   using namespace zonotope;
 
   typedef Zonotope_vertex_adjacency_oracle_CGAL<long, CGAL::Gmpzf>
       Adjacency_oracle_t;
+  typedef Zonotope_vertex_adjacency_oracle<long> Halfspace_adjacency_oracle_t;
 
   int n_tests;
   cin >> n_tests;
@@ -30,7 +44,28 @@ int main() {
     vector<vector<long> > vertices =
         zonotope_vertices<long, Adjacency_oracle_t > (generators);
 
-    cout << n << " " << d << " " << vertices.size() << "\n";
+    vector<vector<long> > vertices_halfspaces =
+        zonotope_vertices<long, Halfspace_adjacency_oracle_t > (generators);
+
+    // zonotope_vertices skips the adjacency oracle for d <= 3
+    vector<vector<long> > vertices_dfs =
+        zonotope_vertices_by_adjacency<long, Halfspace_adjacency_oracle_t > (generators);
+
+    Vertex_counter counter;
+    zonotope_vertices_reverse_search<long, Halfspace_adjacency_oracle_t> (generators, counter);
+
+    Vertex_counter stack_counter;
+    zonotope_vertices_reverse_search_with_stack<long, Halfspace_adjacency_oracle_t> (generators, stack_counter);
+
+    vector<Vertex_counter> parallel_counters (4);
+    const long parallel_count =
+        zonotope_vertices_reverse_search_parallel<long, Halfspace_adjacency_oracle_t> (generators, parallel_counters);
+
+    const vector<long> f_vector = zonotope_f_vector<long> (generators);
+
+    cout << n << " " << d << " " << vertices.size() << " " << vertices_halfspaces.size()
+         << " " << vertices_dfs.size()
+         << " " << counter.count << " " << stack_counter.count << " " << parallel_count << " " << f_vector[0] << "\n";
   }
 
   return 0;
@@ -1,9 +1,14 @@
 #include "zonotope_halfspaces.hpp"
+#include "zonotope_halfspaces_incremental.hpp"
+#include "checked_integer.hpp"
 #include "type_casting_functor.hpp"
 #include "test_utils.hpp"
 
 #include <gmpxx.h>
 #include <iostream>
+#include <algorithm>
+#include <vector>
+#include <set>
 
 
 int main(int argc, char** argv) {
@@ -25,10 +30,42 @@ int main(int argc, char** argv) {
   set<Hyperplane<long> > halfspaces_long;
   zonotope::zonotope_halfspaces<long> (generators_long, halfspaces_long);
 
+  set<Hyperplane<long> > halfspaces_checked;
+  zonotope::zonotope_halfspaces<long, zonotope::Checked_integer> (generators_long, halfspaces_checked);
+
+  vector<Hyperplane<mpz_class> > halfspaces_parallel;
+  zonotope::zonotope_halfspaces_parallel<mpz_class> (generators_mpz, halfspaces_parallel, 4, true);
+
+  vector<Hyperplane<mpz_class> > halfspaces_stream;
+  auto sink = [&halfspaces_stream] ( const Hyperplane<mpz_class>& h ) {
+    halfspaces_stream.push_back(h);
+  };
+  zonotope::zonotope_halfspaces_stream<mpz_class> (generators_mpz, sink);
+  sort(halfspaces_stream.begin(), halfspaces_stream.end());
+
+  // start from the first d generators, and add the others one by one
+  vector<vector<mpz_class> > generators_head (generators_mpz.begin(), generators_mpz.begin() + min(d, n));
+  zonotope::Incremental_zonotope_halfspaces<mpz_class> incremental (generators_head);
+  for ( int k = min(d, n); k < n; ++k ) {
+    incremental.add_generator(generators_mpz[k]);
+  }
+  set<Hyperplane<mpz_class> > halfspaces_incremental;
+  incremental.halfspaces(halfspaces_incremental);
+
   cout << "n=" << n << " "
        << "d=" << d << " "
        << "ieqs=" << halfspaces_mpz.size() << " "
-       << "ieqs_long=" << halfspaces_long.size() << "\n";
+       << "ieqs_long=" << halfspaces_long.size() << " "
+       << "checked_matches=" << ( halfspaces_checked == halfspaces_long ) << " "
+       << "stream_matches="
+       << ( halfspaces_stream.size() == halfspaces_mpz.size() &&
+            equal(halfspaces_mpz.begin(), halfspaces_mpz.end(), halfspaces_stream.begin()) ) << " "
+       << "ieqs_parallel=" << halfspaces_parallel.size() << " "
+       << "parallel_matches="
+       << ( halfspaces_parallel.size() == halfspaces_mpz.size() &&
+            equal(halfspaces_mpz.begin(), halfspaces_mpz.end(), halfspaces_parallel.begin()) ) << " "
+       << "incremental_matches=" << ( halfspaces_incremental == halfspaces_mpz )
+       << "\n";
  
   return 0;
 }
@@ -1,4 +1,7 @@
 #include "zonotope_volume.hpp"
+#include "zonotope_volume_sampling.hpp"
+#include "zonotope.hpp"
+#include "checked_integer.hpp"
 #include "type_casting_functor.hpp"
 #include "test_utils.hpp"
 
@@ -7,6 +10,7 @@
 #include <iostream>
 
 
+#include <cmath>
 #include <cstdlib>
 
 int main(int argc, char** argv) {
@@ -22,10 +26,100 @@ int main(int argc, char** argv) {
 
   mpz_class volume = zonotope::zonotope_volume<mpz_class> (generators_mpz);
   long volume_long = zonotope::zonotope_volume (generators_long);
+  long volume_checked = zonotope::zonotope_volume<long, zonotope::Checked_integer> (generators_long);
+  mpz_class volume_parallel = zonotope::zonotope_volume_parallel<mpz_class> (generators_mpz, 4);
+  zonotope::Volume_estimate<double> volume_approx = zonotope::zonotope_volume_approx (generators_long);
+  const bool approx_within_bound =
+    abs(mpz_class(volume).get_d() - volume_approx.volume) <= volume_approx.error_bound;
+
+  zonotope::Volume_sampling_options sampling_options;
+  sampling_options.num_threads = 4;
+  zonotope::Volume_sampling_estimate volume_sampled =
+    zonotope::zonotope_volume_sampling (generators_long, sampling_options);
+  // the standard error is 0 if there is only one d-subset (n == d),
+  // and the sampled determinants are rounded
+  const bool sampled_within_4_se =
+    abs(mpz_class(volume).get_d() - volume_sampled.volume)
+      <= 4 * volume_sampled.standard_error + 1e-9 * abs(mpz_class(volume).get_d());
+
+  // adding -g for every generator g doubles every class of parallel
+  // generators, and so scales the volume by 2^d
+  vector<vector<mpz_class> > generators_doubled = generators_mpz;
+  for ( const auto& v : generators_mpz ) {
+    vector<mpz_class> minus_v (v);
+    for ( mpz_class& x : minus_v ) {
+      x = -x;
+    }
+    generators_doubled.push_back(minus_v);
+  }
+  const bool parallel_matches =
+    ( zonotope::zonotope_volume<mpz_class> (generators_doubled) == volume * (mpz_class(1) << d) );
+
+  // add all the generators one by one, then remove the first one
+  zonotope::Zonotope<mpz_class> zonotope_incremental (d);
+  for ( const auto& v : generators_mpz ) {
+    zonotope_incremental.add_generator(v);
+  }
+  bool incremental_matches = ( zonotope_incremental.volume() == volume );
+  zonotope_incremental.remove_generator(0);
+  vector<vector<mpz_class> > generators_tail (generators_mpz.begin() + 1, generators_mpz.end());
+  incremental_matches = incremental_matches
+    && ( zonotope_incremental.volume() == zonotope::zonotope_volume<mpz_class> (generators_tail) );
+
+  // the zonotopes of the first d, d+1, ..., n generators in one batch
+  vector<long> packed;
+  for ( const auto& v : generators_long ) {
+    packed.insert(packed.end(), v.begin(), v.end());
+  }
+  const int num_zonotopes = n - d + 1;
+  vector<long> volumes_batch (num_zonotopes);
+  auto generators_of = [&] (const int k) {
+    return zonotope::Matrix_view<const long> (packed.data(), d + k, d, d);
+  };
+  zonotope::zonotope_volume_batch<long, zonotope::Checked_integer>
+    (num_zonotopes, generators_of, volumes_batch.data(), 4);
+  bool batch_matches = true;
+  for ( int k = 0; k < num_zonotopes; ++k ) {
+    vector<vector<long> > prefix (generators_long.begin(), generators_long.begin() + d + k);
+    batch_matches = batch_matches && ( volumes_batch[k] == zonotope::zonotope_volume(prefix) );
+  }
+  // every g_0 + g_k is in the span of g_0 and g_k, so the traversal
+  // skips it below the combinations that contain both. The
+  // floating-point traversal tries every extension.
+  vector<vector<long> > generators_dependent = generators_long;
+  for ( int k = 1; k < n; ++k ) {
+    vector<long> v (generators_long[0]);
+    for ( int j = 0; j < d; ++j ) {
+      v[j] += generators_long[k][j];
+    }
+    generators_dependent.push_back(v);
+  }
+  typedef zonotope::Combination_inverse_stack<mpz_class> Combination_stack_t;
+  zonotope::Matrix<mpz_class> dependent_internal;
+  zonotope::preprocess_generators<long, mpz_class> (generators_dependent, dependent_internal);
+  Combination_stack_t dependent_combination (dependent_internal, d);
+  zonotope::Zonotope_volume_output_functor<mpz_class, Combination_stack_t> dependent_output (dependent_internal);
+  zonotope::Combination_traversal_statistics statistics;
+  zonotope::traverse_combinations_in_place (dependent_combination, dependent_output, &statistics);
+  zonotope::Volume_estimate<double> dependent_approx = zonotope::zonotope_volume_approx (generators_dependent);
+  const bool pruned_matches =
+    abs(dependent_output.volume.get_d() - dependent_approx.volume) <= dependent_approx.error_bound;
+
   cout << "n = " << n << "\n"
        << "d = " << d << "\n"
        << "volume_gmpz = " << volume << "\n"
-       << "volume_long = " << volume_long << "\n\n";
+       << "volume_long = " << volume_long << "\n"
+       << "volume_checked = " << volume_checked << "\n"
+       << "volume_parallel = " << volume_parallel << "\n"
+       << "volume_approx = " << volume_approx.volume << " +- " << volume_approx.error_bound << "\n"
+       << "approx_within_bound = " << approx_within_bound << "\n"
+       << "volume_sampled = " << volume_sampled.volume << " +- " << volume_sampled.standard_error << "\n"
+       << "sampled_within_4_se = " << sampled_within_4_se << "\n"
+       << "parallel_matches = " << parallel_matches << "\n"
+       << "incremental_matches = " << incremental_matches << "\n"
+       << "batch_matches = " << batch_matches << "\n"
+       << "pruned_subtrees = " << statistics.num_pruned_subtrees << "\n"
+       << "pruned_matches = " << pruned_matches << "\n\n";
  
   return 0;
 }